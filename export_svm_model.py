@@ -0,0 +1,102 @@
+'''
+export_svm_model
+
+writes a calibrated linear SVM (CalibratedClassifierCV of LinearSVC) as a
+flat binary model file for `run_kernel -m MODEL -y POSTERIORS.npy`, which
+scores graphlet features in C++ without sklearn or SVML files. the layout
+is described in graphlet_counting/svm_model.h
+
+the model columns must be numbered by a feature vocabulary, i.e. trained on
+features written with `run_kernel -V VOCAB`: line c of VOCAB is the
+feature id of column c. features numbered by svml_to_sparse cannot be
+exported, as its column order is that of a python set and changes between
+runs
+
+args:
+model.pkl, vocabulary file, output model file
+'''
+
+
+import numpy as np
+import pickle
+import struct
+import sys
+
+MAGIC = b'GKMODEL\0'
+VERSION = 1
+BYTE_ORDER_MARK = 0x01020304
+CALIBRATION_SIGMOID = 0
+CALIBRATION_ISOTONIC = 1
+
+
+def read_vocabulary(vocab_f):
+    with open(vocab_f, 'r') as f:
+        return np.array([int(line) for line in f if line.strip()], dtype='<u8')
+
+
+def fold_parts(fold):
+    # attribute names changed across sklearn versions
+    estimator = getattr(fold, 'estimator', None)
+    if estimator is None:
+        estimator = fold.base_estimator
+    calibrators = getattr(fold, 'calibrators', None)
+    if calibrators is None:
+        calibrators = fold.calibrators_
+    return estimator, calibrators
+
+
+def export_svm_model(model_f, vocab_f, out_f):
+    with open(model_f, 'rb') as f:
+        calibrated_svm = pickle.load(f)
+
+    feature_ids = read_vocabulary(vocab_f)
+    folds = calibrated_svm.calibrated_classifiers_
+    n_features = len(feature_ids)
+
+    if len(calibrated_svm.classes_) != 2:
+        sys.exit(f'{model_f}: only binary models can be exported')
+
+    weights = np.zeros((n_features, len(folds)), dtype='<f8')
+    intercepts = np.zeros(len(folds), dtype='<f8')
+    calibration = None
+    sigmoids, points = [], []
+    for k, fold in enumerate(folds):
+        estimator, calibrators = fold_parts(fold)
+        if estimator.coef_.shape != (1, n_features):
+            sys.exit(f'{model_f}: fold {k} has {estimator.coef_.shape[1]} features, {vocab_f} has {n_features}')
+        weights[:, k] = estimator.coef_[0]
+        intercepts[k] = estimator.intercept_[0]
+
+        # binary models have one calibrator, for the positive class
+        calibrator = calibrators[0]
+        if hasattr(calibrator, 'a_'):
+            method = CALIBRATION_SIGMOID
+            sigmoids += [calibrator.a_, calibrator.b_]
+        else:
+            method = CALIBRATION_ISOTONIC
+            points.append((calibrator.X_thresholds_, calibrator.y_thresholds_))
+        if calibration is not None and method != calibration:
+            sys.exit(f'{model_f}: folds are calibrated by different methods')
+        calibration = method
+
+    with open(out_f, 'wb') as f:
+        f.write(MAGIC)
+        f.write(struct.pack('<IIQII', VERSION, BYTE_ORDER_MARK, n_features, len(folds), calibration))
+        f.write(feature_ids.tobytes())
+        f.write(weights.tobytes())
+        f.write(intercepts.tobytes())
+        if calibration == CALIBRATION_SIGMOID:
+            f.write(np.array(sigmoids, dtype='<f8').tobytes())
+        else:
+            offsets = np.cumsum([0] + [len(x) for x, y in points]).astype('<u8')
+            f.write(offsets.tobytes())
+            f.write(np.concatenate([x for x, y in points]).astype('<f8').tobytes())
+            f.write(np.concatenate([y for x, y in points]).astype('<f8').tobytes())
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 4:
+        print(f'Usage: python {sys.argv[0]} <svm_model.pkl> <vocabulary> <output.model>')
+        sys.exit(1)
+
+    export_svm_model(sys.argv[1], sys.argv[2], sys.argv[3])
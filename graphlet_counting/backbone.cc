@@ -0,0 +1,331 @@
+#include "backbone.h"
+#include "mapped_file.h"
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+
+/** Range of bytes of the mapped file. */
+struct Field  {
+    const char *begin, *end;
+
+    Field() : begin(NULL), end(NULL)  {}
+    Field(const char *b, const char *e) : begin(b), end(e)  {}
+
+    inline size_t size() const  { return end - begin; }
+
+    inline bool operator==(const char *s) const  {
+        size_t n = strlen(s);
+        return size() == n && memcmp(begin, s, n) == 0;
+    }
+
+    inline bool operator==(const Field &f) const  {
+        return size() == f.size() && memcmp(begin, f.begin, size()) == 0;
+    }
+
+    inline bool operator!=(const char *s) const  { return !(*this == s); }
+    inline bool operator!=(const Field &f) const  { return !(*this == f); }
+
+    /** Field without leading and trailing blanks. */
+    Field trim() const  {
+        const char *b = begin, *e = end;
+        while (b < e && *b == ' ')
+            b++;
+        while (e > b && e[-1] == ' ')
+            e--;
+        return Field(b, e);
+    }
+};
+
+
+/** One atom record of the chain, before residue grouping. */
+struct AtomRecord  {
+    bool hetero;
+    Field name, resname, resseq, icode;
+    char altloc;
+    float x, y, z, occupancy;
+};
+
+
+// The 20 standard amino acids, which Biopython's is_aa(residue, standard=True) accepts.
+static const char *AMINO_ACIDS[20] = { "ALA", "ARG", "ASN", "ASP", "CYS", "GLN", "GLU", "GLY", "HIS", "ILE",
+                                       "LEU", "LYS", "MET", "PHE", "PRO", "SER", "THR", "TRP", "TYR", "VAL" };
+static const char AMINO_LETTERS[21] = "ARNDCQEGHILKMFPSTWYV";
+
+// One-letter code of a residue name, or 0 if it is not a standard amino acid.
+static char amino_letter(const Field &resname)  {
+    if (resname.size() != 3)
+        return 0;
+    char upper[3];
+    for (unsigned i=0; i<3; i++)
+        upper[i] = toupper(resname.begin[i]);
+    for (unsigned a=0; a<20; a++)  {
+        if (memcmp(upper, AMINO_ACIDS[a], 3) == 0)
+            return AMINO_LETTERS[a];
+    }
+    return 0;
+}
+
+
+/** Groups the atom records of a chain into residues and keeps their backbone atoms. */
+class BackboneBuilder  {
+public:
+    BackboneBuilder(Backbone &b) : backbone(b), in_residue(false), amino(false)  {}
+
+    void add(const AtomRecord &r)  {
+        if (!in_residue || r.hetero != last.hetero || r.resname != last.resname || r.resseq != last.resseq || r.icode != last.icode)  {
+            char letter = amino_letter(r.resname);
+            in_residue = true;
+            amino = letter != 0;
+            last = r;
+            if (amino)
+                backbone.residues.push_back(letter);
+            slot[0] = slot[1] = slot[2] = -1;
+        }
+        if (!amino)
+            return;
+
+        int k = r.name == "N" ? 0 : r.name == "CA" ? 1 : r.name == "C" ? 2 : -1;
+        if (k < 0)
+            return;
+
+        if (slot[k] < 0)  {
+            slot[k] = backbone.labels.size();
+            occupancy[k] = r.occupancy;
+            backbone.atoms.push_back(r.x, r.y, r.z);
+            backbone.labels.push_back("NAC"[k]);
+            backbone.residue_indices.push_back(backbone.residues.size() - 1);
+        }
+        else if (r.altloc != ' ' && r.occupancy > occupancy[k])  {
+            occupancy[k] = r.occupancy;
+            backbone.atoms.x[slot[k]] = r.x;
+            backbone.atoms.y[slot[k]] = r.y;
+            backbone.atoms.z[slot[k]] = r.z;
+        }
+    }
+
+private:
+    Backbone &backbone;
+    bool in_residue, amino;
+    AtomRecord last;        // First record of the current residue.
+    int slot[3];            // Atom index of N, CA and C in the current residue, or -1.
+    float occupancy[3];
+};
+
+
+// Parses a decimal number, allowing blanks around it.
+static bool parse_float(const Field &f, float &value)  {
+    Field t = f.trim();
+    if (t.size() > 0 && *t.begin == '+')
+        t.begin++;
+    from_chars_result r = from_chars(t.begin, t.end, value);
+    return t.size() > 0 && r.ec == errc() && r.ptr == t.end;
+}
+
+
+static void malformed(const char *structure_file, size_t line)  {
+    cerr << "ERROR: Malformed atom record in line " << line << " of structure file " << structure_file << "." << endl; exit(1);
+}
+
+
+// PDB: fixed columns (1-based) 1-6 record name, 13-16 atom name, 17 altloc,
+// 18-20 residue name, 22 chain, 23-26 residue number, 27 insertion code,
+// 31-54 coordinates and 55-60 occupancy. The first model ends at ENDMDL.
+static void read_pdb_backbone(const char *structure_file, const MappedFile &file, const string &chain, BackboneBuilder &builder)  {
+    size_t line_number = 0;
+    for (const char *p = file.begin(); p < file.end(); )  {
+        const char *eol = (const char*) memchr(p, '\n', file.end() - p);
+        if (eol == NULL)
+            eol = file.end();
+        const char *end = eol;
+        if (end > p && end[-1] == '\r')
+            end--;
+        const char *line = p;
+        p = eol + 1;
+        line_number++;
+
+        size_t length = end - line;
+        if (length >= 3 && memcmp(line, "END", 3) == 0 && (length == 3 || line[3] == ' ' || memcmp(line, "ENDMDL", 6) == 0))
+            break;
+        if (length < 6 || (memcmp(line, "ATOM  ", 6) != 0 && memcmp(line, "HETATM", 6) != 0))
+            continue;
+        if (length < 54)
+            malformed(structure_file, line_number);
+        if (chain.size() != 1 || line[21] != chain[0])
+            continue;
+
+        AtomRecord r;
+        r.hetero = line[0] == 'H';
+        r.name = Field(line + 12, line + 16).trim();
+        r.altloc = line[16];
+        r.resname = Field(line + 17, line + 20).trim();
+        r.resseq = Field(line + 22, line + 26).trim();
+        r.icode = Field(line + 26, line + 27);
+        if (!parse_float(Field(line + 30, line + 38), r.x) || !parse_float(Field(line + 38, line + 46), r.y) || !parse_float(Field(line + 46, line + 54), r.z))
+            malformed(structure_file, line_number);
+        if (length < 60 || !parse_float(Field(line + 54, line + 60), r.occupancy))
+            r.occupancy = 1.0;
+        builder.add(r);
+    }
+}
+
+
+/** Whitespace-separated tokens of an mmCIF file, with quotes and text fields unwrapped. */
+class CifTokenizer  {
+public:
+    CifTokenizer(const MappedFile &file) : p(file.begin()), begin(file.begin()), end(file.end())  {}
+
+    /** Reads the next token; returns false at the end of the file. */
+    bool next(Field &token)  {
+        while (p < end)  {
+            if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+                p++;
+            else if (*p == '#')  {
+                while (p < end && *p != '\n')
+                    p++;
+            }
+            else
+                break;
+        }
+        if (p >= end)
+            return false;
+
+        if (*p == ';' && (p == begin || p[-1] == '\n'))  {
+            // Text field: up to the next line that starts with ';'.
+            const char *b = ++p;
+            while (p < end && !(*p == ';' && p[-1] == '\n'))
+                p++;
+            token = Field(b, p);
+            if (p < end)
+                p++;
+        }
+        else if (*p == '\'' || *p == '"')  {
+            // Quoted value: ends at the same quote followed by whitespace.
+            char quote = *p;
+            const char *b = ++p;
+            while (p < end && !(*p == quote && (p + 1 == end || p[1] == ' ' || p[1] == '\t' || p[1] == '\r' || p[1] == '\n')))
+                p++;
+            token = Field(b, p);
+            if (p < end)
+                p++;
+        }
+        else  {
+            const char *b = p;
+            while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+                p++;
+            token = Field(b, p);
+        }
+        return true;
+    }
+
+    /** Returns the position of the tokenizer, to read a token again. */
+    inline const char *position() const  { return p; }
+    inline void rewind(const char *position)  { p = position; }
+
+private:
+    const char *p, *begin, *end;
+};
+
+
+// mmCIF: the _atom_site loop, with the columns Biopython's MMCIFParser reads
+// (label atom and residue names, author chain and residue number). The first
+// model ends where pdbx_PDB_model_num changes.
+static void read_cif_backbone(const char *structure_file, const MappedFile &file, const string &chain, BackboneBuilder &builder)  {
+    enum { GROUP, ATOM, ALT, RESNAME, CHAIN, RESSEQ, ICODE, X, Y, Z, OCCUPANCY, MODEL, COLUMNS };
+    const char *names[COLUMNS] = { "group_PDB", "label_atom_id", "label_alt_id", "label_comp_id", "auth_asym_id", "auth_seq_id",
+                                   "pdbx_PDB_ins_code", "Cartn_x", "Cartn_y", "Cartn_z", "occupancy", "pdbx_PDB_model_num" };
+    const char *prefix = "_atom_site.";
+    size_t prefix_length = strlen(prefix);
+
+    CifTokenizer tokens(file);
+    Field token;
+    bool found = false;
+    while (!found && tokens.next(token))
+        found = token == "loop_" && tokens.next(token) && token.size() > prefix_length && memcmp(token.begin, prefix, prefix_length) == 0;
+    if (!found)  {
+        cerr << "ERROR: No _atom_site loop in structure file " << structure_file << "." << endl; exit(1);
+    }
+
+    // Column of every field of interest, in the order of the loop header.
+    int column[COLUMNS];
+    for (unsigned c=0; c<COLUMNS; c++)
+        column[c] = -1;
+    unsigned columns = 0;
+    const char *position;
+    do  {
+        Field name(token.begin + prefix_length, token.end);
+        for (unsigned c=0; c<COLUMNS; c++)  {
+            if (name == names[c])
+                column[c] = columns;
+        }
+        columns++;
+        position = tokens.position();
+    } while (tokens.next(token) && token.size() > prefix_length && memcmp(token.begin, prefix, prefix_length) == 0);
+    tokens.rewind(position);
+
+    for (unsigned c=0; c<COLUMNS; c++)  {
+        if (column[c] < 0 && c != ALT && c != ICODE && c != OCCUPANCY && c != MODEL)  {
+            cerr << "ERROR: No _atom_site." << names[c] << " column in structure file " << structure_file << "." << endl; exit(1);
+        }
+    }
+
+    vector<Field> row(columns);
+    Field first_model;
+    size_t record = 0;
+    while (true)  {
+        position = tokens.position();
+        if (!tokens.next(row[0]) || *row[0].begin == '_' || row[0] == "loop_" || (row[0].size() >= 5 && memcmp(row[0].begin, "data_", 5) == 0))
+            break;
+        for (unsigned c=1; c<columns; c++)  {
+            if (!tokens.next(row[c]))  {
+                cerr << "ERROR: Truncated _atom_site record " << record + 1 << " in structure file " << structure_file << "." << endl; exit(1);
+            }
+        }
+        record++;
+
+        if (column[MODEL] >= 0)  {
+            if (record == 1)
+                first_model = row[column[MODEL]];
+            else if (row[column[MODEL]] != first_model)
+                break;
+        }
+        if (row[column[CHAIN]] != chain.c_str())
+            continue;
+
+        AtomRecord r;
+        Field absent;
+        r.hetero = row[column[GROUP]] == "HETATM";
+        r.name = row[column[ATOM]];
+        r.resname = row[column[RESNAME]];
+        r.resseq = row[column[RESSEQ]];
+        r.icode = column[ICODE] >= 0 && row[column[ICODE]] != "?" && row[column[ICODE]] != "." ? row[column[ICODE]] : absent;
+        r.altloc = column[ALT] >= 0 && row[column[ALT]] != "." && row[column[ALT]] != "?" ? *row[column[ALT]].begin : ' ';
+        if (!parse_float(row[column[X]], r.x) || !parse_float(row[column[Y]], r.y) || !parse_float(row[column[Z]], r.z))  {
+            cerr << "ERROR: Malformed coordinates in _atom_site record " << record << " of structure file " << structure_file << "." << endl; exit(1);
+        }
+        if (column[OCCUPANCY] < 0 || !parse_float(row[column[OCCUPANCY]], r.occupancy))
+            r.occupancy = 1.0;
+        builder.add(r);
+    }
+}
+
+
+Backbone read_backbone(const char *structure_file, const string &chain)  {
+    MappedFile file;
+    if (!file.open(structure_file))  {
+        cerr << "ERROR: Structure file " << structure_file << " could not be opened." << endl; exit(1);
+    }
+
+    Backbone backbone;
+    BackboneBuilder builder(backbone);
+    size_t length = strlen(structure_file);
+    if (length >= 4 && strcasecmp(structure_file + length - 4, ".cif") == 0)
+        read_cif_backbone(structure_file, file, chain, builder);
+    else
+        read_pdb_backbone(structure_file, file, chain, builder);
+
+    if (backbone.residues.empty())  {
+        cerr << "ERROR: No amino acids in chain " << chain << " of structure file " << structure_file << "." << endl; exit(1);
+    }
+    return backbone;
+}
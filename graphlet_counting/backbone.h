@@ -0,0 +1,38 @@
+/**
+ * Backbone atoms of a protein chain read from PDB or mmCIF files.
+ *
+ * Selects the atoms make_graph uses: N, CA and C of the standard amino
+ * acids of one chain in the first model, in file order. The file is
+ * memory-mapped and scanned in place (fixed columns for PDB, whitespace
+ * tokens of the _atom_site loop for mmCIF), so no string is built per line.
+ *
+ * Records follow Biopython's structure builder: a residue is a run of
+ * records with the same residue name, number and insertion code, and of
+ * alternate locations of an atom the one with the highest occupancy (the
+ * first on ties) is kept, at the position of its first record.
+ *
+ */
+
+#ifndef __BACKBONE_H__
+#define __BACKBONE_H__
+
+#include "contact_graph.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+
+/** N, CA and C atoms of a chain, one entry per atom in every array. */
+struct Backbone  {
+    AtomCoordinates atoms;
+    string labels;                      // N, A (CA) or C, as in .atom_labels files.
+    vector<unsigned> residue_indices;   // Residue of each atom, as in .atom_res_indices files.
+    string residues;                    // One-letter code of every standard amino acid of the chain.
+};
+
+
+/** Reads the backbone of chain in the first model of a PDB file, or of an
+ *  mmCIF file if the name ends in .cif. */
+Backbone read_backbone(const char *structure_file, const string &chain = "A");
+
+#endif
@@ -0,0 +1,1023 @@
+/**
+ * Micro-benchmarks for the graphlet counting data structures.
+ *
+ * Usage: benchmark [-g G_FILE -l L_FILE] [-x COORDS [-i RES]] [-r REPEATS]
+ *
+ * Defaults to the example graph in example/data, and to atoms on a jittered
+ * lattice with the density of a protein backbone for the contact graph
+ * benchmark. Every benchmark runs the
+ * same workload on the old and the new implementation and reports the
+ * elapsed time of both.
+ *
+ */
+
+#include "config.h"
+#include "contact_graph.h"
+#include "gkernel.h"
+#include "graph_file.h"
+#include "mismatches.h"
+#include "simgraph.h"
+#include "string.h"
+#include "svm_model.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <unistd.h>
+using namespace std;
+
+
+/** Graphlet insertion event: orbit, labels as enumerated, canonical key and its permutation subset. */
+struct Insertion  {
+    unsigned long g_type;
+    char root, labels[4];
+    Key key;
+    vector<Key> mismatches;
+};
+
+
+static double elapsed(chrono::steady_clock::time_point start)  {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static void report(const string &name, double old_time, double new_time)  {
+    cout << name << ": " << old_time << " s vs " << new_time << " s (" << old_time / new_time << "x)" << endl;
+}
+
+// Records the graphlets rooted at g_root that only use the root and its
+// neighbors (1-graphlets, edges, 3- and 4-vertex stars with their induced
+// edges), in the order GraphKernel::count_graphlets_from inserts them.
+static void record_insertions(const SimpleGraph &g, unsigned g_root, vector<Insertion> &stream)  {
+    char root = g.nodes[g_root];
+    Insertion ins;
+
+    ins.g_type = 0;
+    ins.root = root;
+    ins.labels[0] = ins.labels[1] = ins.labels[2] = ins.labels[3] = ZERO_CHAR;
+    ins.key = canonical_key(root, ZERO_CHAR, ZERO_CHAR, ZERO_CHAR, ZERO_CHAR, 0);
+    create_permutations_subset(ins.mismatches, ins.key, 0);
+    stream.push_back(ins);
+
+    const vector<unsigned> &nbrs = g.adj[g_root];
+    for (unsigned i_=0; i_<nbrs.size(); i_++)  {
+        unsigned i = nbrs[i_];
+        char a = g.nodes[i];
+        ins.mismatches.clear();
+        ins.g_type = 1;
+        ins.labels[0] = a;
+        ins.key = canonical_key(root, a, ZERO_CHAR, ZERO_CHAR, ZERO_CHAR, 1);
+        create_permutations_subset(ins.mismatches, ins.key, 1);
+        stream.push_back(ins);
+
+        for (unsigned j_=0; j_<i_; j_++)  {
+            unsigned j = nbrs[j_];
+            char b = g.nodes[j];
+            ins.mismatches.clear();
+            ins.labels[2] = ZERO_CHAR;
+            ins.g_type = g.has_edge(i, j) ? 4 : 3;
+            ins.labels[0] = a; ins.labels[1] = b;
+            ins.key = canonical_key(root, a, b, ZERO_CHAR, ZERO_CHAR, ins.g_type);
+            create_permutations_subset(ins.mismatches, ins.key, ins.g_type);
+            stream.push_back(ins);
+
+            for (unsigned k_=0; k_<j_; k_++)  {
+                unsigned k = nbrs[k_];
+                char c = g.nodes[k];
+                unsigned edges = g.has_edge(i, j) + g.has_edge(i, k) + g.has_edge(j, k);
+                ins.mismatches.clear();
+                ins.g_type = (edges == 0) ? 7 : (edges == 1) ? 10 : (edges == 2) ? 14 : 15;
+                ins.labels[0] = a; ins.labels[1] = b; ins.labels[2] = c;
+                ins.key = canonical_key(root, a, b, c, ZERO_CHAR, ins.g_type);
+                create_permutations_subset(ins.mismatches, ins.key, ins.g_type);
+                stream.push_back(ins);
+            }
+        }
+    }
+}
+
+// Graphlet table entry and insertion pattern of increment_match_hash before
+// the tables were switched to MismatchHash, with every label permutation
+// stored in a per-entry map.
+struct MapMismatchInfo  {
+    float matches;
+    float mismatches;
+    map<Key, float> mismatchesGraph;
+};
+
+static void increment_match_map(map<Key,MapMismatchInfo> &hash, const Key &k, vector<Key> &mismatches_list)  {
+    map<Key,MapMismatchInfo>::iterator it;
+    if ((it = hash.find(k)) == hash.end())  {
+        hash[k].matches = 1.0;
+        hash[k].mismatches = 0.0;
+        for (vector<Key>::iterator mismatch_key = mismatches_list.begin(); mismatch_key < mismatches_list.end(); mismatch_key++)  {
+            hash[k].mismatchesGraph[*mismatch_key] = 0.0;
+        }
+    }
+    else  {
+        hash[k].matches = it->second.matches + 1.0;
+    }
+    mismatches_list.clear();
+}
+
+// Builds the per-root graphlet tables with std::map and with MismatchHash.
+static void benchmark_graphlet_tables(const SimpleGraph &g, unsigned repeats)  {
+    vector<vector<Insertion> > streams(g.adj.size());
+    size_t events = 0;
+    for (unsigned v=0; v<g.adj.size(); v++)  {
+        record_insertions(g, v, streams[v]);
+        events += streams[v].size();
+    }
+
+    double checksum_old = 0.0, checksum_new = 0.0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        for (unsigned v=0; v<streams.size(); v++)  {
+            vector<map<Key,MapMismatchInfo> > hash(GRAPHLET_TYPES);
+            for (unsigned e=0; e<streams[v].size(); e++)  {
+                vector<Key> mismatches(streams[v][e].mismatches);
+                increment_match_map(hash[streams[v][e].g_type], streams[v][e].key, mismatches);
+            }
+            for (unsigned t=0; t<GRAPHLET_TYPES; t++)
+                checksum_old += hash[t].size();
+        }
+    }
+    double old_time = elapsed(start);
+
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        for (unsigned v=0; v<streams.size(); v++)  {
+            vector<MismatchHash> hash(GRAPHLET_TYPES);
+            for (unsigned e=0; e<streams[v].size(); e++)
+                increment_match_hash(hash[streams[v][e].g_type], streams[v][e].key);
+            for (unsigned t=0; t<GRAPHLET_TYPES; t++)  {
+                hash[t].sort_by_key();
+                checksum_new += hash[t].size();
+            }
+        }
+    }
+    double new_time = elapsed(start);
+
+    if (checksum_old != checksum_new)  {
+        cerr << "ERROR: Graphlet tables differ (" << checksum_old << " vs " << checksum_new << " entries)." << endl; exit(1);
+    }
+    cout << "Graphlet tables, " << events * repeats << " insertions" << endl;
+    report("  std::map vs MismatchHash", old_time, new_time);
+}
+
+static Key batch_keys(LabelBatch &batch, const char *roots, unsigned long g_type)  {
+    Key sum = 0;
+    canonical_labels_batch(batch, g_type);
+    for (unsigned i=0; i<batch.size; i++)
+        sum += make_key(roots[i], batch.column[0][i], batch.column[1][i], batch.column[2][i], batch.column[3][i], g_type);
+    batch.size = 0;
+    return sum;
+}
+
+// Canonicalizes the enumerated labelings one at a time and in column-wise
+// batches per orbit, as count_graphlets_from does.
+static void benchmark_canonicalization(const SimpleGraph &g, unsigned repeats)  {
+    vector<Insertion> stream;
+    for (unsigned v=0; v<g.adj.size(); v++)
+        record_insertions(g, v, stream);
+
+    Key checksum_old = 0, checksum_new = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        for (unsigned e=0; e<stream.size(); e++)  {
+            const Insertion &ins = stream[e];
+            checksum_old += canonical_key(ins.root, ins.labels[0], ins.labels[1], ins.labels[2], ins.labels[3], ins.g_type);
+        }
+    }
+    double old_time = elapsed(start);
+
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        vector<LabelBatch> batches(GRAPHLET_TYPES);
+        vector<char> roots(GRAPHLET_TYPES * LABEL_BATCH);
+        for (unsigned e=0; e<stream.size(); e++)  {
+            const Insertion &ins = stream[e];
+            LabelBatch &batch = batches[ins.g_type];
+            roots[ins.g_type*LABEL_BATCH+batch.size] = ins.root;
+            for (unsigned p=0; p<4; p++)
+                batch.column[p][batch.size] = ins.labels[p];
+            if (++batch.size == LABEL_BATCH)
+                checksum_new += batch_keys(batch, &roots[ins.g_type*LABEL_BATCH], ins.g_type);
+        }
+        for (unsigned long t=0; t<GRAPHLET_TYPES; t++)
+            checksum_new += batch_keys(batches[t], &roots[t*LABEL_BATCH], t);
+    }
+    double new_time = elapsed(start);
+
+    if (checksum_old != checksum_new)  {
+        cerr << "ERROR: Canonical keys differ." << endl; exit(1);
+    }
+    cout << "Canonicalization, " << stream.size() * repeats << " labelings" << endl;
+    report("  one at a time vs batched", old_time, new_time);
+}
+
+// Cases 011 (triangles and 3-paths) and 0112 (4-paths and 4-cycles through a
+// vertex at distance 2) around g_root, one occurrence at a time on the whole
+// graph, as count_graphlets_from counted them before neighborhoods were extracted.
+static void count_by_occurrence(const SimpleGraph &g, unsigned g_root, BfsBuffers &bfs, vector<MismatchHash> &hash)  {
+    g.bounded_bfs(g_root, GRAPHLET_DEPTH, bfs);
+    GraphletBuffer graphlets(g.nodes[g_root], hash);
+    const vector<unsigned> &nbrs = g.adj[g_root];
+    for (unsigned i_=0; i_<nbrs.size(); i_++)  {
+        unsigned i = nbrs[i_];
+        char a = g.nodes[i];
+        for (unsigned j_=0; j_<i_; j_++)
+            graphlets.add(g.has_edge(i, nbrs[j_]) ? 4 : 3, a, g.nodes[nbrs[j_]], ZERO_CHAR, ZERO_CHAR);
+        for (unsigned j_=0; j_<nbrs.size(); j_++)  {
+            if (i_ == j_)  continue;
+            unsigned j = nbrs[j_];
+            char b = g.nodes[j];
+            bool found_ij = g.has_edge(i, j);
+            for (unsigned k_=0; k_<g.adj[i].size(); k_++)  {
+                unsigned k = g.adj[i][k_];
+                if (bfs.distance(k) != 2)  continue;
+                char c = g.nodes[k];
+                if (g.has_edge(j, k))  {
+                    if (i_ < j_)
+                        graphlets.add(found_ij ? 13 : 12, a, b, c, ZERO_CHAR);
+                }
+                else
+                    graphlets.add(found_ij ? 11 : 6, b, a, c, ZERO_CHAR);
+            }
+        }
+    }
+    graphlets.flush();
+}
+
+// The same cases on the extracted neighborhood, per label with LabelRows
+// (search and copy included), as count_graphlets_from counts them.
+static void count_by_label(const SimpleGraph &g, unsigned g_root, BfsBuffers &bfs, SimpleGraph &local, LabelRows &label_rows, vector<MismatchHash> &hash)  {
+    g.extract_neighborhood(g_root, GRAPHLET_DEPTH, bfs, local);
+    if (!local.has_bit_matrix())  {
+        cerr << "ERROR: Neighborhood of vertex " << g_root << " has no bit matrix." << endl; exit(1);
+    }
+    label_rows.build(local, bfs.level);
+    GraphletBuffer graphlets(local.nodes[0], hash);
+    const vector<unsigned> &nbrs = local.adj[0];
+    for (unsigned i_=0; i_<nbrs.size(); i_++)  {
+        unsigned i = nbrs[i_];
+        if (i_ > 0)
+            label_rows.pass(local, nbrs[i_-1]);
+        label_rows.add_triangles(graphlets, local, i);
+        label_rows.select_second(local, i);
+        for (unsigned j_=0; j_<nbrs.size(); j_++)  {
+            if (i_ != j_)
+                label_rows.count_second(local, nbrs[j_], local.has_edge(i, nbrs[j_]), i_ < j_);
+        }
+        label_rows.add_second(graphlets, local.nodes[i]);
+    }
+    graphlets.flush();
+}
+
+static unsigned long long graphlet_checksum(vector<MismatchHash> &hash)  {
+    unsigned long long checksum = 0;
+    for (unsigned t=0; t<GRAPHLET_TYPES; t++)  {
+        for (MismatchHash::iterator it = hash[t].begin(); it != hash[t].end(); it++)
+            checksum += (it->first + t) * (unsigned long long) it->second.matches;
+    }
+    return checksum;
+}
+
+static void benchmark_local_neighborhoods(const SimpleGraph &g, unsigned repeats)  {
+    unsigned long long checksum_old = 0, checksum_new = 0;
+    SimpleGraph local;
+    BfsBuffers bfs;
+    LabelRows label_rows;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        for (unsigned v=0; v<g.adj.size(); v++)  {
+            vector<MismatchHash> hash(GRAPHLET_TYPES);
+            count_by_occurrence(g, v, bfs, hash);
+            checksum_old += graphlet_checksum(hash);
+        }
+    }
+    double old_time = elapsed(start);
+
+    size_t vertices = 0;
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        for (unsigned v=0; v<g.adj.size(); v++)  {
+            vector<MismatchHash> hash(GRAPHLET_TYPES);
+            count_by_label(g, v, bfs, local, label_rows, hash);
+            checksum_new += graphlet_checksum(hash);
+            vertices += local.adj.size();
+        }
+    }
+    double new_time = elapsed(start);
+
+    if (checksum_old != checksum_new)  {
+        cerr << "ERROR: Graphlet counts differ on extracted neighborhoods." << endl; exit(1);
+    }
+    cout << "Triangles and 4-cycles (cases 011 and 0112), " << vertices / max<size_t>(repeats * g.adj.size(), 1) << " vertices per neighborhood" << endl;
+    report("  per occurrence on whole graph vs per label on local bit matrix", old_time, new_time);
+}
+
+// Distances from every root by a full breadth-first search and by one that
+// stops GRAPHLET_DEPTH hops away, reusing its buffers.
+static void benchmark_bfs(const SimpleGraph &g, unsigned repeats)  {
+    unsigned long long checksum_old = 0, checksum_new = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        for (unsigned v=0; v<g.adj.size(); v++)  {
+            vector<unsigned> dist = g.breadth_first_sort(v);
+            for (unsigned u=0; u<dist.size(); u++)
+                checksum_old += (dist[u] <= GRAPHLET_DEPTH) ? dist[u] + 1 : 0;
+        }
+    }
+    double old_time = elapsed(start);
+
+    BfsBuffers bfs;
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        for (unsigned v=0; v<g.adj.size(); v++)  {
+            g.bounded_bfs(v, GRAPHLET_DEPTH, bfs);
+            for (unsigned q=0; q<bfs.order.size(); q++)
+                checksum_new += bfs.level[q] + 1;
+        }
+    }
+    double new_time = elapsed(start);
+
+    // All vertices as roots, BFS_BATCH at a time, each search unpacked as
+    // get_graphlets_counts does.
+    unsigned long long checksum_batch = 0;
+    vector<unsigned> roots(g.adj.size());
+    for (unsigned v=0; v<roots.size(); v++)
+        roots[v] = v;
+    MultiSourceBfs batch;
+    BfsBuffers scratch;
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        for (unsigned first=0; first<roots.size(); first+=BFS_BATCH)  {
+            g.multi_source_bfs(&roots[first], min<unsigned>(BFS_BATCH, roots.size() - first), GRAPHLET_DEPTH, batch, scratch);
+            for (unsigned s=0; s<batch.size(); s++)  {
+                batch.get(s, bfs);
+                for (unsigned q=0; q<bfs.order.size(); q++)
+                    checksum_batch += bfs.level[q] + 1;
+            }
+        }
+    }
+    double batch_time = elapsed(start);
+
+    if (checksum_old != checksum_new || checksum_old != checksum_batch)  {
+        cerr << "ERROR: Bounded distances differ." << endl; exit(1);
+    }
+    cout << "Breadth-first search, " << g.adj.size() * repeats << " roots" << endl;
+    report("  full vs depth-bounded", old_time, new_time);
+    report("  depth-bounded vs multi-source", new_time, batch_time);
+}
+
+// Contact graph the way make_graph builds it, comparing all pairs of atoms.
+static SimpleGraph all_pairs_contact_graph(const AtomCoordinates &atoms, const string &labels, float threshold)  {
+    SimpleGraph g;
+    g.nodes = labels;
+    g.adj.resize(atoms.size());
+    for (unsigned i=0; i<atoms.size(); i++)  {
+        for (unsigned j=i+1; j<atoms.size(); j++)  {
+            float ex = atoms.x[i] - atoms.x[j], ey = atoms.y[i] - atoms.y[j], ez = atoms.z[i] - atoms.z[j];
+            if (sqrtf(ex * ex + ey * ey + ez * ez) <= threshold)  {
+                g.adj[i].push_back(j);
+                g.adj[j].push_back(i);
+            }
+        }
+    }
+    for (unsigned i=0; i<atoms.size(); i++)
+        sort(g.adj[i].begin(), g.adj[i].end());
+    g.index_edges();
+    return g;
+}
+
+// About one backbone atom per 45 cubic A, as in a folded protein.
+static AtomCoordinates lattice_atoms(unsigned side)  {
+    AtomCoordinates atoms;
+    srand(1);
+    for (unsigned i=0; i<side; i++)
+        for (unsigned j=0; j<side; j++)
+            for (unsigned k=0; k<side; k++)
+                atoms.push_back(3.5 * i + randdouble(), 3.5 * j + randdouble(), 3.5 * k + randdouble());
+    return atoms;
+}
+
+static void benchmark_contact_graph(const AtomCoordinates &atoms, unsigned repeats)  {
+    string labels(atoms.size(), 'A');
+    size_t edges_old = 0, edges_new = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        SimpleGraph g = all_pairs_contact_graph(atoms, labels, CONTACT_THRESHOLD);
+        for (unsigned i=0; i<g.adj.size(); i++)
+            edges_old += g.adj[i].size();
+    }
+    double old_time = elapsed(start);
+
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        SimpleGraph g = contact_graph(atoms, labels, CONTACT_THRESHOLD);
+        for (unsigned i=0; i<g.adj.size(); i++)
+            edges_new += g.adj[i].size();
+    }
+    double new_time = elapsed(start);
+
+    if (edges_old != edges_new)  {
+        cerr << "ERROR: Contact graphs differ (" << edges_old << " vs " << edges_new << " edges)." << endl; exit(1);
+    }
+    cout << "Contact graph, " << atoms.size() << " atoms, " << edges_new / (2 * max(repeats, 1u)) << " contacts" << endl;
+    report("  all pairs vs cell grid", old_time, new_time);
+}
+
+// Threshold sweep 6.0 - 9.0 A: one cell grid per threshold, or one pass at 9.0
+// with every threshold taken as prefixes of the distance-sorted contacts.
+static void benchmark_threshold_sweep(const AtomCoordinates &atoms, unsigned repeats)  {
+    const float thresholds[] = { 6.0, 6.5, 7.0, 7.5, 8.0, 8.5, 9.0 };
+    const unsigned count = sizeof(thresholds) / sizeof(thresholds[0]);
+    string labels(atoms.size(), 'A');
+    size_t edges_old = 0, edges_new = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        for (unsigned t=0; t<count; t++)  {
+            SimpleGraph g = contact_graph(atoms, labels, thresholds[t]);
+            for (unsigned i=0; i<g.adj.size(); i++)
+                edges_old += g.adj[i].size();
+        }
+    }
+    double old_time = elapsed(start);
+
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        ContactDistances contacts = contact_distances(atoms, labels, thresholds[count-1]);
+        for (unsigned t=0; t<count; t++)  {
+            SimpleGraph g = contacts.graph(thresholds[t]);
+            for (unsigned i=0; i<g.adj.size(); i++)
+                edges_new += g.adj[i].size();
+        }
+    }
+    double new_time = elapsed(start);
+
+    if (edges_old != edges_new)  {
+        cerr << "ERROR: Threshold sweep graphs differ (" << edges_old << " vs " << edges_new << " edges)." << endl; exit(1);
+    }
+    cout << "Contact graphs for " << count << " thresholds, " << atoms.size() << " atoms" << endl;
+    report("  cell grid per threshold vs distance-sorted prefixes", old_time, new_time);
+}
+
+// Mean distance between the numbers of adjacent vertices, a proxy for how far
+// apart in memory a search reads consecutive rows.
+static double mean_edge_span(const SimpleGraph &g)  {
+    double span = 0.0;
+    size_t entries = 0;
+    for (unsigned v=0; v<g.adj.size(); v++)  {
+        for (unsigned t=0; t<g.adj[v].size(); t++)
+            span += fabs((double) g.adj[v][t] - (double) v);
+        entries += g.adj[v].size();
+    }
+    return span / max<size_t>(entries, 1);
+}
+
+// Bounded searches and neighborhood copies from every root of the contact
+// graph, numbered in input order, randomly, by RCM and along a Hilbert curve.
+static void benchmark_vertex_order(const AtomCoordinates &atoms, unsigned repeats)  {
+    SimpleGraph g = contact_graph(atoms, string(atoms.size(), 'A'), CONTACT_THRESHOLD);
+    unsigned n = g.adj.size();
+
+    vector<unsigned> shuffled(n);
+    for (unsigned v=0; v<n; v++)
+        shuffled[v] = v;
+    srand(1);
+    for (unsigned v=n; v>1; v--)
+        swap(shuffled[v-1], shuffled[randint(v)]);
+
+    const char *names[] = { "input", "random", "reverse Cuthill-McKee", "Hilbert curve" };
+    vector<unsigned> orders[] = { vector<unsigned>(), shuffled, g.rcm_order(), hilbert_order(atoms) };
+    double times[4];
+    unsigned long long checksums[4];
+
+    cout << "Vertex order, contact graph of " << n << " atoms" << endl;
+    for (unsigned o=0; o<4; o++)  {
+        SimpleGraph h = orders[o].empty() ? g : g.permuted(orders[o]);
+        BfsBuffers bfs;
+        SimpleGraph local;
+        checksums[o] = 0;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (unsigned r=0; r<repeats; r++)  {
+            for (unsigned v=0; v<n; v++)  {
+                h.extract_neighborhood(v, GRAPHLET_DEPTH, bfs, local);
+                for (unsigned u=0; u<local.adj.size(); u++)
+                    checksums[o] += local.adj[u].size();
+            }
+        }
+        times[o] = elapsed(start);
+        cout << "  " << names[o] << ": mean edge span " << mean_edge_span(h) << endl;
+    }
+
+    if (checksums[1] != checksums[0] || checksums[2] != checksums[0] || checksums[3] != checksums[0])  {
+        cerr << "ERROR: Neighborhoods differ between vertex orders." << endl; exit(1);
+    }
+    report("  random vs input order", times[1], times[0]);
+    report("  random vs reverse Cuthill-McKee", times[1], times[2]);
+    report("  random vs Hilbert curve", times[1], times[3]);
+}
+
+// Every vertex of the contact graph as a root, listed in random order: batched
+// searches and neighborhood copies with the roots processed as listed, in
+// breadth-first (RCM) order and along a Hilbert curve, as run_kernel -r does,
+// then whole runs of 4 threads as listed and along the Hilbert curve.
+static void benchmark_root_order(const AtomCoordinates &atoms, unsigned repeats)  {
+    SimpleGraph g = contact_graph(atoms, string(atoms.size(), 'A'), CONTACT_THRESHOLD);
+    unsigned n = g.adj.size();
+
+    vector<unsigned> listed(n);
+    for (unsigned v=0; v<n; v++)
+        listed[v] = v;
+    srand(2);
+    for (unsigned v=n; v>1; v--)
+        swap(listed[v-1], listed[randint(v)]);
+
+    const char *names[] = { "as listed", "breadth-first", "Hilbert curve" };
+    vector<unsigned> orders[] = { listed, g.rcm_order(), hilbert_order(atoms) };
+    double times[3];
+    unsigned long long checksums[3];
+
+    for (unsigned o=0; o<3; o++)  {
+        MultiSourceBfs batch;
+        BfsBuffers scratch, bfs;
+        SimpleGraph local;
+        checksums[o] = 0;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (unsigned r=0; r<repeats; r++)  {
+            for (unsigned first=0; first<n; first+=BFS_BATCH)  {
+                g.multi_source_bfs(&orders[o][first], min<unsigned>(BFS_BATCH, n - first), GRAPHLET_DEPTH, batch, scratch);
+                for (unsigned s=0; s<batch.size(); s++)  {
+                    batch.get(s, bfs);
+                    g.extract_neighborhood(GRAPHLET_DEPTH, bfs, local);
+                    for (unsigned u=0; u<local.adj.size(); u++)
+                        checksums[o] += local.adj[u].size();
+                }
+            }
+        }
+        times[o] = elapsed(start);
+    }
+
+    if (checksums[1] != checksums[0] || checksums[2] != checksums[0])  {
+        cerr << "ERROR: Neighborhoods differ between root orders." << endl; exit(1);
+    }
+    cout << "Root order, " << n << " roots listed in random order" << endl;
+    report(string("  ") + names[0] + " vs " + names[1], times[0], times[1]);
+    report(string("  ") + names[0] + " vs " + names[2], times[0], times[2]);
+
+    // Standard graphlet features of the same roots with 4 threads, as
+    // run_kernel -j 4 -r 0 and -j 4 -r 2: each thread keeps a slice of the
+    // Hilbert order rather than a share of the roots sorted by cost.
+    const unsigned root_orders[] = { ROOTS_INPUT, ROOTS_SPATIAL };
+    double threaded[2];
+    for (unsigned o=0; o<2; o++)  {
+        GraphKernel gk;
+        gk.set_threads(4);
+        gk.set_root_order(root_orders[o]);
+        gk.read_contact_graph(atoms, string(n, 'A'), CONTACT_THRESHOLD, listed);
+        gk.set_labels(vector<int>(n, 1));
+        gk.set_number_label_mismatches(0.0);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (unsigned r=0; r<repeats; r++)
+            gk.write_sparse_svml_lm("/dev/null");
+        threaded[o] = elapsed(start);
+    }
+    report(string("  4 threads, ") + names[0] + " vs " + names[2], threaded[0], threaded[1]);
+}
+
+// Standard graphlet features of every atom of the contact graph, with the
+// contacts limited by each policy: size of the graph and counting time.
+static void benchmark_contact_policies(const AtomCoordinates &atoms, const vector<unsigned> &residues)  {
+    const char *names[] = { "all contacts", "sequence separation 3", "8 nearest", "degree 12", "8 nearest, degree 12" };
+    ContactPolicy policies[5];
+    policies[1].min_separation = 3;
+    policies[2].nearest = 8;
+    policies[3].max_degree = 12;
+    policies[4].nearest = 8;
+    policies[4].max_degree = 12;
+
+    unsigned n = atoms.size();
+    string labels(n, 'A');
+    vector<unsigned> roots(n);
+    for (unsigned v=0; v<n; v++)
+        roots[v] = v;
+
+    cout << "Contact policies, " << n << " atoms, standard graphlet kernel" << endl;
+    double all_time = 0.0;
+    for (unsigned p=0; p<5; p++)  {
+        SimpleGraph g = contact_graph(atoms, labels, CONTACT_THRESHOLD, policies[p], residues);
+        size_t entries = 0, max_degree = 0;
+        for (unsigned v=0; v<n; v++)  {
+            entries += g.adj[v].size();
+            max_degree = max(max_degree, g.adj[v].size());
+        }
+
+        GraphKernel gk;
+        gk.set_contact_policy(policies[p], residues);
+        gk.read_contact_graph(atoms, labels, CONTACT_THRESHOLD, roots);
+        gk.set_labels(vector<int>(n, 1));
+        gk.set_number_label_mismatches(0.0);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        gk.write_sparse_svml_lm("/dev/null");
+        double time = elapsed(start);
+        if (p == 0)
+            all_time = time;
+
+        cout << "  " << names[p] << ": " << entries / 2 << " contacts, max degree " << max_degree << ", " << time << " s (" << all_time / time << "x)" << endl;
+    }
+}
+
+// SVML lines to CSR arrays as svml_to_sparse does it: split every token,
+// collect (row, feature id) -> count, then number the ids in a set.
+static size_t svml_to_csr(const char *svml_file, vector<int64_t> &indptr, vector<int64_t> &indices, vector<float> &data)  {
+    map<pair<unsigned, Key>, float> entries;
+    set<Key> ids;
+    ifstream in(svml_file, ios::in);
+    string line;
+    unsigned rows = 0;
+    while (getline(in, line))  {
+        vector<string> tokens = split(line, ' ');
+        for (unsigned t=1; t+1<tokens.size(); t++)  {
+            vector<string> pair = split(tokens[t], ':');
+            Key id = strtoul(pair[0].c_str(), NULL, 10);
+            entries[make_pair(rows, id)] = to_f(pair[1]);
+            ids.insert(id);
+        }
+        rows++;
+    }
+
+    map<Key, int64_t> column;
+    for (set<Key>::iterator it = ids.begin(); it != ids.end(); it++)
+        column.insert(make_pair(*it, (int64_t) column.size()));
+    indptr.assign(rows + 1, 0);
+    for (map<pair<unsigned, Key>, float>::iterator it = entries.begin(); it != entries.end(); it++)  {
+        indptr[it->first.first + 1]++;
+        indices.push_back(column[it->first.second]);
+        data.push_back(it->second);
+    }
+    for (unsigned i=0; i<rows; i++)
+        indptr[i+1] += indptr[i];
+    return ids.size();
+}
+
+// Standard graphlet features of every vertex, written as SVML and converted
+// to CSR arrays, or written as CSR arrays and mapped.
+static void benchmark_feature_output(const string &g_file, const string &l_file, unsigned repeats)  {
+    char prefix[] = "/tmp/benchmark_features_XXXXXX";
+    int fd = mkstemp(prefix);
+    if (fd < 0)  {
+        cerr << "ERROR: Temporary feature file could not be created." << endl; exit(1);
+    }
+    close(fd);
+    string svml_file = string(prefix) + ".svml", csr = prefix;
+
+    double write_time[2];
+    for (unsigned f=0; f<2; f++)  {
+        GraphKernel gk;
+        SimpleGraph g = SimpleGraph::read_graph(l_file.c_str(), g_file.c_str());
+        vector<unsigned> roots(g.adj.size());
+        for (unsigned v=0; v<roots.size(); v++)
+            roots[v] = v;
+        gk.read_graphs(l_file, g_file, roots);
+        gk.set_labels(vector<int>(roots.size(), 1));
+        gk.set_number_label_mismatches(0.0);
+        if (f == 1)
+            gk.set_sparse_csr();
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        gk.write_sparse_svml_lm(f == 0 ? svml_file.c_str() : csr.c_str());
+        write_time[f] = elapsed(start);
+    }
+
+    size_t entries_old = 0, entries_new = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        vector<int64_t> indptr, indices;
+        vector<float> data;
+        svml_to_csr(svml_file.c_str(), indptr, indices, data);
+        entries_old += indices.size();
+    }
+    double old_time = elapsed(start);
+
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)  {
+        MappedFile indptr, indices, data;
+        if (!indptr.open((csr + ".indptr.npy").c_str()) || !indices.open((csr + ".indices.npy").c_str()) || !data.open((csr + ".data.npy").c_str()))  {
+            cerr << "ERROR: CSR arrays could not be mapped." << endl; exit(1);
+        }
+        const unsigned char *header = (const unsigned char*) data.begin();
+        entries_new += (data.size() - 10 - (header[8] | header[9] << 8)) / sizeof(float);
+    }
+    double new_time = elapsed(start);
+
+    const char *suffixes[] = { ".svml", ".indptr.npy", ".indices.npy", ".data.npy", ".labels.npy", ".roots.npy", "" };
+    for (unsigned s=0; s<7; s++)
+        unlink((csr + suffixes[s]).c_str());
+    if (entries_old != entries_new)  {
+        cerr << "ERROR: CSR arrays have " << entries_new / max(repeats, 1u) << " entries, SVML " << entries_old / max(repeats, 1u) << "." << endl; exit(1);
+    }
+
+    cout << "Feature output, " << entries_new / max(repeats, 1u) << " entries" << endl;
+    report("  counting and writing, SVML vs CSR arrays", write_time[0], write_time[1]);
+    report("  SVML to CSR conversion vs mapping CSR arrays", old_time, new_time);
+}
+
+// Writes a sigmoid-calibrated model file over the feature ids, with arbitrary weights.
+static void write_test_model(const char *file, const vector<Key> &ids, unsigned folds, vector<double> &weights, vector<double> &intercepts, vector<double> &sigmoids)  {
+    SvmModelHeader header;
+    memcpy(header.magic, "GKMODEL", 8);
+    header.version = SVM_MODEL_VERSION;
+    header.byte_order = 0x01020304;
+    header.features = ids.size();
+    header.folds = folds;
+    header.calibration = CALIBRATION_SIGMOID;
+
+    weights.resize(ids.size() * folds);
+    for (size_t w=0; w<weights.size(); w++)
+        weights[w] = 0.01 * sin((double) w);
+    intercepts.assign(folds, -1.0);
+    sigmoids.resize(2 * folds);
+    for (unsigned k=0; k<folds; k++)  {
+        sigmoids[2*k] = -1.0 - 0.1 * k;
+        sigmoids[2*k+1] = 0.1 * k;
+    }
+
+    vector<uint64_t> columns(ids.begin(), ids.end());
+    ofstream out(file, ios::out | ios::binary);
+    out.write((const char*) &header, sizeof(header));
+    out.write((const char*) columns.data(), 8 * columns.size());
+    out.write((const char*) weights.data(), 8 * weights.size());
+    out.write((const char*) intercepts.data(), 8 * intercepts.size());
+    out.write((const char*) sigmoids.data(), 8 * sigmoids.size());
+}
+
+// Posteriors of every vertex under a 5-fold calibrated linear SVM: SVML written,
+// converted to CSR arrays and scored like predict_proba, or every root scored
+// in process as soon as it is counted.
+static void benchmark_svm_scoring(const string &g_file, const string &l_file)  {
+    char prefix[] = "/tmp/benchmark_scoring_XXXXXX";
+    int fd = mkstemp(prefix);
+    if (fd < 0)  {
+        cerr << "ERROR: Temporary scoring file could not be created." << endl; exit(1);
+    }
+    close(fd);
+    string svml_file = string(prefix) + ".svml", model_file = string(prefix) + ".model", posteriors_file = prefix;
+    const unsigned folds = 5;
+
+    vector<double> old_posteriors, new_posteriors;
+    double old_time = 0.0, new_time = 0.0;
+    vector<double> weights, intercepts, sigmoids;
+    for (unsigned f=0; f<2; f++)  {
+        GraphKernel gk;
+        SimpleGraph g = SimpleGraph::read_graph(l_file.c_str(), g_file.c_str());
+        vector<unsigned> roots(g.adj.size());
+        for (unsigned v=0; v<roots.size(); v++)
+            roots[v] = v;
+        gk.read_graphs(l_file, g_file, roots);
+        gk.set_labels(vector<int>(roots.size(), 1));
+        gk.set_number_label_mismatches(0.0);
+
+        SvmModel model;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        if (f == 0)  {
+            gk.write_sparse_svml_lm(svml_file.c_str());
+            vector<int64_t> indptr, indices;
+            vector<float> data;
+            svml_to_csr(svml_file.c_str(), indptr, indices, data);
+            old_time = elapsed(start);
+
+            // svml_to_csr numbers the ids in increasing order; the model gets the same columns.
+            set<Key> ids;
+            ifstream in(svml_file.c_str(), ios::in);
+            string line;
+            while (getline(in, line))  {
+                vector<string> tokens = split(line, ' ');
+                for (unsigned t=1; t+1<tokens.size(); t++)
+                    ids.insert(strtoul(tokens[t].c_str(), NULL, 10));
+            }
+            write_test_model(model_file.c_str(), vector<Key>(ids.begin(), ids.end()), folds, weights, intercepts, sigmoids);
+
+            start = chrono::steady_clock::now();
+            for (unsigned i=0; i+1<indptr.size(); i++)  {
+                double sum = 0.0;
+                for (unsigned k=0; k<folds; k++)  {
+                    double score = intercepts[k];
+                    for (int64_t t=indptr[i]; t<indptr[i+1]; t++)
+                        score += weights[indices[t] * folds + k] * data[t];
+                    sum += 1.0 / (1.0 + exp(sigmoids[2*k] * score + sigmoids[2*k+1]));
+                }
+                old_posteriors.push_back(sum / folds);
+            }
+            old_time += elapsed(start);
+        }
+        else  {
+            model.open(model_file.c_str());
+            gk.set_svm_model(&model);
+            gk.write_sparse_svml_lm(posteriors_file.c_str());
+            new_time = elapsed(start);
+
+            MappedFile posteriors;
+            if (!posteriors.open(posteriors_file.c_str()))  {
+                cerr << "ERROR: Posteriors could not be mapped." << endl; exit(1);
+            }
+            const unsigned char *header = (const unsigned char*) posteriors.begin();
+            const double *p = (const double*) (posteriors.begin() + 10 + (header[8] | header[9] << 8));
+            new_posteriors.assign(p, (const double*) posteriors.end());
+        }
+    }
+
+    unlink(prefix);
+    unlink(svml_file.c_str());
+    unlink(model_file.c_str());
+    if (old_posteriors.size() != new_posteriors.size())  {
+        cerr << "ERROR: " << new_posteriors.size() << " posteriors scored in process, " << old_posteriors.size() << " from SVML." << endl; exit(1);
+    }
+    for (unsigned i=0; i<old_posteriors.size(); i++)  {
+        if (fabs(old_posteriors[i] - new_posteriors[i]) > 1e-9)  {
+            cerr << "ERROR: Posterior of root " << i << " is " << new_posteriors[i] << " in process, " << old_posteriors[i] << " from SVML." << endl; exit(1);
+        }
+    }
+
+    cout << "SVM scoring, " << new_posteriors.size() << " roots, " << weights.size() / folds << " features, " << folds << " folds" << endl;
+    report("  SVML, conversion and scoring vs scoring while counting", old_time, new_time);
+}
+
+// Mean posterior of every residue as run_svm_inference computes it: the atom of
+// each example taken from the front of the list of examples, a string key per
+// atom, and a new residue whenever the key changes.
+static vector<double> keyed_residue_means(const vector<unsigned> &examples, const vector<unsigned> &residues, const vector<double> &posteriors)  {
+    vector<unsigned> pending(examples);
+    vector<string> keys;
+    for (unsigned i=0; i<posteriors.size(); i++)  {
+        unsigned atom = pending.front();
+        pending.erase(pending.begin());
+        ostringstream key;
+        key << "pdb_" << residues[atom];
+        keys.push_back(key.str());
+    }
+
+    vector<double> means, run;
+    string previous;
+    for (unsigned i=0; i<keys.size(); i++)  {
+        if (keys[i] != previous)  {
+            if (!run.empty())
+                means.push_back(accumulate(run.begin(), run.end(), 0.0) / run.size());
+            run.assign(1, posteriors[i]);
+        }
+        else
+            run.push_back(posteriors[i]);
+        previous = keys[i];
+    }
+    if (!run.empty())
+        means.push_back(accumulate(run.begin(), run.end(), 0.0) / run.size());
+    return means;
+}
+
+// Mean posterior of the residues of all atoms, by string keys or in one pass.
+static void benchmark_residue_aggregation(const vector<unsigned> &residues, unsigned repeats)  {
+    vector<unsigned> examples;
+    vector<double> posteriors;
+    for (unsigned v=0; v<residues.size(); v++)  {
+        examples.push_back(v);
+        posteriors.push_back(0.5 + 0.5 * sin((double) v));
+    }
+
+    vector<double> old_means, new_means;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)
+        old_means = keyed_residue_means(examples, residues, posteriors);
+    double old_time = elapsed(start);
+
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)
+        new_means = residue_posteriors(posteriors, residues, REDUCE_MEAN);
+    double new_time = elapsed(start);
+
+    if (new_means != old_means)  {
+        cerr << "ERROR: Residue posteriors differ (" << new_means.size() << " vs " << old_means.size() << " residues)." << endl; exit(1);
+    }
+
+    cout << "Residue aggregation, " << residues.size() << " atoms, " << new_means.size() << " residues" << endl;
+    report("  string keys vs one pass", old_time, new_time);
+}
+
+// Graph reader before the mapped tokenizer: getline, split on tabs, to_i and a
+// linear scan of the row for every neighbor.
+static SimpleGraph split_read_graph(const char *nlabels_file, const char *graph_file)  {
+    SimpleGraph g;
+    g.nodes = SimpleGraph::read_labels(nlabels_file);
+    g.adj.resize(g.nodes.size());
+
+    ifstream gin(graph_file, ios::in);
+    string line;
+    while (getline(gin, line))  {
+        vector<string> tokens = split(line, '\t');
+        unsigned i = to_i(tokens[0]);
+        for (unsigned j=1; j<tokens.size(); j++)  {
+            unsigned k = to_i(tokens[j]);
+            if (find(g.adj[i].begin(), g.adj[i].end(), k) == g.adj[i].end())
+                g.adj[i].push_back(k);
+        }
+    }
+    g.index_edges();
+    return g;
+}
+
+// Loading the graph from the text graph and labels files, or from the binary graph file.
+static void benchmark_graph_loading(const string &g_file, const string &l_file, unsigned repeats)  {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)
+        SimpleGraph g = split_read_graph(l_file.c_str(), g_file.c_str());
+    double split_time = elapsed(start);
+
+    SimpleGraph text = SimpleGraph::read_graph(l_file.c_str(), g_file.c_str());
+    char binary_file[] = "/tmp/benchmark_graph_XXXXXX";
+    int fd = mkstemp(binary_file);
+    if (fd < 0)  {
+        cerr << "ERROR: Temporary graph file could not be created." << endl; exit(1);
+    }
+    close(fd);
+    write_graph_file(binary_file, text);
+
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)
+        SimpleGraph g = SimpleGraph::read_graph(l_file.c_str(), g_file.c_str());
+    double old_time = elapsed(start);
+
+    start = chrono::steady_clock::now();
+    for (unsigned r=0; r<repeats; r++)
+        SimpleGraph g = read_graph_file(binary_file);
+    double new_time = elapsed(start);
+
+    SimpleGraph binary = read_graph_file(binary_file);
+    unlink(binary_file);
+    if (binary.adj != text.adj || binary.nodes != text.nodes)  {
+        cerr << "ERROR: Binary graph file differs from the text graph." << endl; exit(1);
+    }
+
+    cout << "Graph loading, " << text.adj.size() << " vertices" << endl;
+    report("  getline and split vs mapped tokenizer", split_time, old_time);
+    report("  text vs binary graph file", old_time, new_time);
+}
+
+
+int main(int argc, char *argv[])  {
+    string g_file("example/data/1A0R_P.graph"), l_file("example/data/1A0R_P.labels"), coords_file, residues_file;
+    unsigned repeats(20);
+
+    for (int i=1; i<argc; i++)  {
+        if (argv[i][0] != '-' || strlen(argv[i]) != 2 || i+1 >= argc)  {
+            cerr << "Usage: benchmark [-g G_FILE -l L_FILE] [-x COORDS [-i RES]] [-r REPEATS]" << endl; exit(1);
+        }
+        switch (argv[i][1])  {
+            case 'g': g_file = argv[++i]; break;
+            case 'l': l_file = argv[++i]; break;
+            case 'x': coords_file = argv[++i]; break;
+            case 'i': residues_file = argv[++i]; break;
+            case 'r': repeats = to_i(argv[++i]); break;
+            default: cerr << "ERROR: Unknown option " << argv[i] << endl; exit(1);
+        }
+    }
+
+    SimpleGraph g = SimpleGraph::read_graph(l_file.c_str(), g_file.c_str());
+    cout << "Graph " << g_file << ": " << g.adj.size() << " vertices" << endl;
+
+    benchmark_graph_loading(g_file, l_file, repeats);
+    benchmark_feature_output(g_file, l_file, repeats);
+    benchmark_svm_scoring(g_file, l_file);
+    benchmark_graphlet_tables(g, repeats);
+    benchmark_canonicalization(g, repeats);
+    benchmark_bfs(g, repeats);
+    benchmark_local_neighborhoods(g, repeats);
+    AtomCoordinates atoms = coords_file.empty() ? lattice_atoms(16) : read_coordinates(coords_file.c_str());
+    benchmark_contact_graph(atoms, repeats);
+    benchmark_threshold_sweep(atoms, repeats);
+    benchmark_vertex_order(atoms, repeats);
+    benchmark_root_order(atoms, repeats);
+
+    // Lattice atoms are numbered as three per residue.
+    vector<unsigned> residues;
+    if (residues_file.empty())  {
+        for (unsigned v=0; v<atoms.size(); v++)
+            residues.push_back(v / 3);
+    }
+    else
+        residues = read_residue_indices(residues_file.c_str());
+    benchmark_contact_policies(atoms, residues);
+    benchmark_residue_aggregation(residues, repeats);
+
+    return 0;
+}
@@ -0,0 +1,248 @@
+/**
+ * Canonical labelings of rooted graphlets.
+ *
+ * The non-root vertices of every orbit are passed in a fixed order (a,b,c,d).
+ * Vertices that a symmetry of the orbit can exchange are described by a few
+ * compare-exchange steps: running them over the labels sorts every group of
+ * exchangeable vertices and yields the canonical (lexicographically smallest)
+ * labeling. The symmetry group generated by the exchanges gives the label
+ * permutations allowed for the orbit. Both the steps and the group elements
+ * are tables generated at compile time from the per-orbit symmetry classes.
+ *
+ */
+
+#ifndef __CANONICAL_H__
+#define __CANONICAL_H__
+
+#include "config.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+#define MAX_SYMMETRIES 24 // Order of the largest symmetry group (4 exchangeable vertices).
+#define MAX_EXCHANGES 5   // Comparators of the largest sorting network (4 vertices).
+#define NO_VERTEX 4       // Position of the always-empty label, pads single-vertex exchanges.
+#define LABEL_BATCH 32    // Labelings canonicalized together by canonical_labels_batch.
+
+
+/** Compare-exchange step: the labels at (x0,x1) and (y0,y1) are compared
+ *  lexicographically and swapped if the second pair is smaller. Single
+ *  vertices use NO_VERTEX as their second position. */
+struct Exchange  {
+    unsigned char x0, x1, y0, y1;
+};
+
+/** Symmetries of an orbit: its sorting network and the group the network's
+ *  exchanges generate, as permutations of the positions a,b,c,d. */
+struct OrbitSymmetry  {
+    unsigned char exchanges;
+    Exchange exchange[MAX_EXCHANGES];
+    unsigned char size;
+    unsigned char perm[MAX_SYMMETRIES][4];
+};
+
+
+// Which non-root vertices of an orbit can be exchanged.
+enum SymmetryClass  {
+    SYMMETRY_NONE,      // P-A-B-C-D
+    SYMMETRY_AB,        // P-A1-A2-B-C
+    SYMMETRY_BC,        // P-A-B1-B2-C
+    SYMMETRY_CD,        // P-A-B-C1-C2
+    SYMMETRY_ABC,       // P-A1-A2-A3-B
+    SYMMETRY_BCD,       // P-A-B1-B2-B3
+    SYMMETRY_ABCD,      // P-A1-A2-A3-A4
+    SYMMETRY_AB_CD,     // P-A1-A2-B1-B2
+    SYMMETRY_PAIRS,     // P-A1-A2-a1-a2, the pairs themselves can be exchanged too
+    SYMMETRY_MIRROR,    // P-A1-A2-B1-B2, only (A1,B1) and (A2,B2) as a whole
+    SYMMETRY_CLASSES
+};
+
+static const unsigned char ORBIT_SYMMETRY[GRAPHLET_TYPES] = {
+    SYMMETRY_NONE,   SYMMETRY_NONE,   SYMMETRY_NONE,   SYMMETRY_AB,     SYMMETRY_AB,      //  0- 4
+    SYMMETRY_NONE,   SYMMETRY_NONE,   SYMMETRY_BC,     SYMMETRY_ABC,    SYMMETRY_BC,      //  5- 9
+    SYMMETRY_BC,     SYMMETRY_NONE,   SYMMETRY_AB,     SYMMETRY_AB,     SYMMETRY_AB,      // 10-14
+    SYMMETRY_ABC,    SYMMETRY_ABCD,   SYMMETRY_AB_CD,  SYMMETRY_PAIRS,  SYMMETRY_BC,      // 15-19
+    SYMMETRY_MIRROR, SYMMETRY_BCD,    SYMMETRY_ABC,    SYMMETRY_PAIRS,  SYMMETRY_BC,      // 20-24
+    SYMMETRY_AB_CD,  SYMMETRY_ABCD,   SYMMETRY_MIRROR, SYMMETRY_MIRROR, SYMMETRY_MIRROR,  // 25-29
+    SYMMETRY_NONE,   SYMMETRY_MIRROR, SYMMETRY_NONE,   SYMMETRY_NONE,   SYMMETRY_AB_CD,   // 30-34
+    SYMMETRY_AB_CD,  SYMMETRY_AB_CD,  SYMMETRY_NONE,   SYMMETRY_AB_CD,  SYMMETRY_CD,      // 35-39
+    SYMMETRY_CD,     SYMMETRY_CD,     SYMMETRY_CD,     SYMMETRY_AB,     SYMMETRY_AB,      // 40-44
+    SYMMETRY_NONE,   SYMMETRY_BC,     SYMMETRY_NONE,   SYMMETRY_NONE,   SYMMETRY_AB,      // 45-49
+    SYMMETRY_BC,     SYMMETRY_ABC,    SYMMETRY_BC,     SYMMETRY_NONE,   SYMMETRY_AB,      // 50-54
+    SYMMETRY_BC,     SYMMETRY_BC,     SYMMETRY_BC,     SYMMETRY_ABC,    SYMMETRY_BCD,     // 55-59
+    SYMMETRY_CD,     SYMMETRY_CD,     SYMMETRY_BCD,    SYMMETRY_NONE,   SYMMETRY_NONE,    // 60-64
+    SYMMETRY_AB,     SYMMETRY_AB,     SYMMETRY_NONE,   SYMMETRY_BC,     SYMMETRY_NONE,    // 65-69
+    SYMMETRY_BC,     SYMMETRY_CD,     SYMMETRY_CD,     SYMMETRY_NONE                      // 70-73
+};
+
+
+// Sorting network of every symmetry class.
+constexpr OrbitSymmetry symmetry_exchanges(unsigned c)  {
+    OrbitSymmetry s = {};
+    const unsigned char N = NO_VERTEX;
+    const Exchange AB = {0, N, 1, N}, BC = {1, N, 2, N}, CD = {2, N, 3, N}, AC = {0, N, 2, N}, BD = {1, N, 3, N};
+    switch (c)  {
+        case SYMMETRY_AB:     s.exchange[s.exchanges++] = AB; break;
+        case SYMMETRY_BC:     s.exchange[s.exchanges++] = BC; break;
+        case SYMMETRY_CD:     s.exchange[s.exchanges++] = CD; break;
+        case SYMMETRY_ABC:    s.exchange[s.exchanges++] = AB; s.exchange[s.exchanges++] = BC; s.exchange[s.exchanges++] = AB; break;
+        case SYMMETRY_BCD:    s.exchange[s.exchanges++] = BC; s.exchange[s.exchanges++] = CD; s.exchange[s.exchanges++] = BC; break;
+        case SYMMETRY_ABCD:
+            s.exchange[s.exchanges++] = AB; s.exchange[s.exchanges++] = CD;
+            s.exchange[s.exchanges++] = AC; s.exchange[s.exchanges++] = BD;
+            s.exchange[s.exchanges++] = BC;
+            break;
+        case SYMMETRY_AB_CD:  s.exchange[s.exchanges++] = AB; s.exchange[s.exchanges++] = CD; break;
+        case SYMMETRY_PAIRS:
+            s.exchange[s.exchanges++] = AB; s.exchange[s.exchanges++] = CD;
+            s.exchange[s.exchanges++] = Exchange{0, 1, 2, 3};
+            break;
+        case SYMMETRY_MIRROR: s.exchange[s.exchanges++] = Exchange{0, 2, 1, 3}; break;
+        default: break;
+    }
+    return s;
+}
+
+// Closes the exchanges of a sorting network under composition.
+constexpr OrbitSymmetry symmetry_group(unsigned c)  {
+    OrbitSymmetry s = symmetry_exchanges(c);
+
+    for (unsigned i=0; i<4; i++)
+        s.perm[0][i] = i;
+    s.size = 1;
+
+    for (unsigned p=0; p<s.size; p++)  {
+        for (unsigned e=0; e<s.exchanges; e++)  {
+            unsigned char q[5] = {s.perm[p][0], s.perm[p][1], s.perm[p][2], s.perm[p][3], NO_VERTEX};
+            const Exchange &x = s.exchange[e];
+            unsigned char t = q[x.x0]; q[x.x0] = q[x.y0]; q[x.y0] = t;
+            t = q[x.x1]; q[x.x1] = q[x.y1]; q[x.y1] = t;
+
+            bool found = false;
+            for (unsigned r=0; r<s.size && !found; r++)
+                found = (s.perm[r][0] == q[0] && s.perm[r][1] == q[1] && s.perm[r][2] == q[2] && s.perm[r][3] == q[3]);
+            if (!found)  {
+                for (unsigned i=0; i<4; i++)
+                    s.perm[s.size][i] = q[i];
+                s.size++;
+            }
+        }
+    }
+    return s;
+}
+
+struct SymmetryTables  {
+    OrbitSymmetry symmetry[SYMMETRY_CLASSES];
+};
+
+constexpr SymmetryTables symmetry_tables()  {
+    SymmetryTables t = {};
+    for (unsigned c=0; c<SYMMETRY_CLASSES; c++)
+        t.symmetry[c] = symmetry_group(c);
+    return t;
+}
+
+static constexpr SymmetryTables SYMMETRIES = symmetry_tables();
+
+static_assert(SYMMETRIES.symmetry[SYMMETRY_ABCD].size == 24, "S4 expected for four exchangeable vertices");
+static_assert(SYMMETRIES.symmetry[SYMMETRY_PAIRS].size == 8, "Dihedral group expected for exchangeable pairs");
+static_assert(SYMMETRIES.symmetry[SYMMETRY_MIRROR].size == 2, "Mirror symmetry expected");
+
+
+// Number of non-root vertices of each orbit.
+constexpr unsigned char orbit_vertices(unsigned g_type)  {
+    return (g_type == 0) ? 0 : (g_type == 1) ? 1 : (g_type <= 4) ? 2 : (g_type <= 15) ? 3 : 4;
+}
+
+
+/** Sorts labels l[0..3] in place into the canonical labeling of orbit g_type;
+ *  l[NO_VERTEX] must hold ZERO_CHAR. Labels beyond the orbit's vertices are
+ *  cleared. */
+inline void canonical_labels(char *l, unsigned long g_type)  {
+    for (unsigned i=orbit_vertices(g_type); i<4; i++)
+        l[i] = ZERO_CHAR;
+
+    const OrbitSymmetry &s = SYMMETRIES.symmetry[ORBIT_SYMMETRY[g_type]];
+    for (unsigned e=0; e<s.exchanges; e++)  {
+        const Exchange &x = s.exchange[e];
+        char x0 = l[x.x0], x1 = l[x.x1], y0 = l[x.y0], y1 = l[x.y1];
+        bool swap = (y0 < x0) | ((y0 == x0) & (y1 < x1));
+        l[x.x0] = swap ? y0 : x0; l[x.y0] = swap ? x0 : y0;
+        l[x.x1] = swap ? y1 : x1; l[x.y1] = swap ? x1 : y1;
+    }
+}
+
+/** Labelings of up to LABEL_BATCH graphlets of one orbit, stored column-wise
+ *  (column[p][i] is the label at position p of the i-th graphlet) so that each
+ *  step of a sorting network compares whole columns. */
+struct LabelBatch  {
+    unsigned char column[4][LABEL_BATCH];
+    unsigned size;
+};
+
+/** Sorts every labeling of the batch into the canonical labeling of orbit
+ *  g_type, like canonical_labels. All LABEL_BATCH lanes are processed, so
+ *  lanes past size must hold some (ignored) label. */
+inline void canonical_labels_batch(LabelBatch &batch, unsigned long g_type)  {
+    for (unsigned i=orbit_vertices(g_type); i<4; i++)  {
+        for (unsigned j=0; j<LABEL_BATCH; j++)
+            batch.column[i][j] = ZERO_CHAR;
+    }
+
+    const OrbitSymmetry &s = SYMMETRIES.symmetry[ORBIT_SYMMETRY[g_type]];
+    for (unsigned e=0; e<s.exchanges; e++)  {
+        const Exchange &x = s.exchange[e];
+        unsigned char *x0 = batch.column[x.x0], *y0 = batch.column[x.y0];
+
+        if (x.x1 == NO_VERTEX)  {
+            // Single vertices: the smaller label goes first.
+#if defined(__SSE2__)
+            for (unsigned j=0; j<LABEL_BATCH; j+=16)  {
+                __m128i u = _mm_loadu_si128((const __m128i *) (x0 + j));
+                __m128i v = _mm_loadu_si128((const __m128i *) (y0 + j));
+                _mm_storeu_si128((__m128i *) (x0 + j), _mm_min_epu8(u, v));
+                _mm_storeu_si128((__m128i *) (y0 + j), _mm_max_epu8(u, v));
+            }
+#else
+            for (unsigned j=0; j<LABEL_BATCH; j++)  {
+                unsigned char u = x0[j], v = y0[j];
+                x0[j] = (v < u) ? v : u;
+                y0[j] = (v < u) ? u : v;
+            }
+#endif
+        }
+        else  {
+            // Pairs of vertices: swap both when (y0,y1) < (x0,x1).
+            unsigned char *x1 = batch.column[x.x1], *y1 = batch.column[x.y1];
+#if defined(__SSE2__)
+            for (unsigned j=0; j<LABEL_BATCH; j+=16)  {
+                __m128i u0 = _mm_loadu_si128((const __m128i *) (x0 + j)), u1 = _mm_loadu_si128((const __m128i *) (x1 + j));
+                __m128i v0 = _mm_loadu_si128((const __m128i *) (y0 + j)), v1 = _mm_loadu_si128((const __m128i *) (y1 + j));
+                // v < u  <=>  max(u,v) != v
+                __m128i lt0 = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_max_epu8(u0, v0), v0), _mm_set1_epi8(-1));
+                __m128i lt1 = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_max_epu8(u1, v1), v1), _mm_set1_epi8(-1));
+                __m128i swap = _mm_or_si128(lt0, _mm_and_si128(_mm_cmpeq_epi8(u0, v0), lt1));
+                _mm_storeu_si128((__m128i *) (x0 + j), _mm_or_si128(_mm_and_si128(swap, v0), _mm_andnot_si128(swap, u0)));
+                _mm_storeu_si128((__m128i *) (y0 + j), _mm_or_si128(_mm_and_si128(swap, u0), _mm_andnot_si128(swap, v0)));
+                _mm_storeu_si128((__m128i *) (x1 + j), _mm_or_si128(_mm_and_si128(swap, v1), _mm_andnot_si128(swap, u1)));
+                _mm_storeu_si128((__m128i *) (y1 + j), _mm_or_si128(_mm_and_si128(swap, u1), _mm_andnot_si128(swap, v1)));
+            }
+#else
+            for (unsigned j=0; j<LABEL_BATCH; j++)  {
+                unsigned char u0 = x0[j], u1 = x1[j], v0 = y0[j], v1 = y1[j];
+                bool swap = (v0 < u0) | ((v0 == u0) & (v1 < u1));
+                x0[j] = swap ? v0 : u0; y0[j] = swap ? u0 : v0;
+                x1[j] = swap ? v1 : u1; y1[j] = swap ? u1 : v1;
+            }
+#endif
+        }
+    }
+}
+
+/** Symmetries (sorting network and permutation group) of orbit g_type. */
+inline const OrbitSymmetry &orbit_symmetry(unsigned long g_type)  {
+    return SYMMETRIES.symmetry[ORBIT_SYMMETRY[g_type]];
+}
+
+#endif
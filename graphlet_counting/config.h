@@ -29,11 +29,13 @@
 #define GRAPHLETS_3 1 // If 1 use 3-graphlets when counting, otherwise do not consider 3-graphlets.
 #define GRAPHLETS_4 1 // If 1 use 4-graphlets when counting, otherwise do not consider 4-graphlets.
 #define GRAPHLETS_5 0 // If 1 use 5-graphlets when counting, otherwise do not consider 5-graphlets.
+#define GRAPHLET_DEPTH (GRAPHLETS_5 ? 4 : 3) // Distance from the root of the farthest vertex the enumeration reaches; vertices at this distance are never expanded.
 
 #define OUTPUT_FORMAT 2 // If 0 print kernel matrix in binary format (for efficient SVM^light), 
                         // If 1 print triangular kernel matrix to standard output, 
                         // Otherwise, print to standard output.
 
+#include <algorithm>
 #include <fstream>
 #include <utility>
 #include <list>
@@ -45,12 +47,54 @@ using namespace std;
 typedef unsigned long Key;
 
 
+// Counts for the label-substitution keys of one graphlet, kept sorted by key in
+// a single contiguous block. With n vertices, up to m substitutions and an
+// alphabet of s labels there are at most sum_{j<=m} C(n,j)*(s-1)^j keys (3706 for
+// 5-graphlets, 2 substitutions and 20 amino acids). Empty, and thus not
+// allocated, unless vertex label substitutions are counted.
+class PermutationCounts
+{
+public:
+    typedef pair<Key, float> value_type;
+    typedef vector<value_type>::iterator iterator;
+    typedef vector<value_type>::const_iterator const_iterator;
+
+    inline iterator begin()  { return entries.begin(); }
+    inline iterator end()  { return entries.end(); }
+    inline const_iterator begin() const  { return entries.begin(); }
+    inline const_iterator end() const  { return entries.end(); }
+    inline size_t size() const  { return entries.size(); }
+    inline bool empty() const  { return entries.empty(); }
+
+    iterator find(const Key &k)  {
+        iterator it = lower_bound(entries.begin(), entries.end(), value_type(k, 0.0), compare_keys);
+        return (it != entries.end() && it->first == k) ? it : entries.end();
+    }
+
+    // Sets the permutations to the given keys with zero counts.
+    void assign(const vector<Key> &keys)  {
+        entries.clear();
+        entries.reserve(keys.size());
+        for (size_t i=0; i<keys.size(); i++)
+            entries.push_back(value_type(keys[i], 0.0));
+        sort(entries.begin(), entries.end(), compare_keys);
+        entries.erase(unique(entries.begin(), entries.end(), same_keys), entries.end());
+    }
+
+private:
+    static inline bool compare_keys(const value_type &a, const value_type &b)  { return a.first < b.first; }
+    static inline bool same_keys(const value_type &a, const value_type &b)  { return a.first == b.first; }
+
+    vector<value_type> entries;
+};
+
+
 // Enhanced data structure to accommodate for label and edge mismatches.
 struct MismatchInfo
 {
     float matches;						// Contains counts for exact non-isomorphic labeled graphlets found.
     float mismatches;					// Contains counts for inexact non-isomorphic labeled graphlets obtained by edge indels algorithm.
-    map<Key, float> mismatchesGraph;	// Contains counts for each inexact non-isomorphic labeled graphlet generated by label substitutions algorithm and satisfying SIMILARITY_THRESHOLD (defined above).
+    PermutationCounts mismatchesGraph;	// Contains counts for each inexact non-isomorphic labeled graphlet generated by label substitutions algorithm and satisfying SIMILARITY_THRESHOLD (defined above).
 };
 
 #endif
@@ -0,0 +1,380 @@
+#include "contact_graph.h"
+#include "flat_hash.h"
+#include "string.h"
+#include "text_reader.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+
+AtomCoordinates read_coordinates(const char *coords_file)  {
+    TextReader in;
+    if (!in.open(coords_file))  {
+        cerr << "ERROR: Coordinates file " << coords_file << " could not be opened." << endl; exit(1);
+    }
+
+    AtomCoordinates atoms;
+    while (in.next_line())  {
+        float x, y, z;
+        if (!in.next_float(x) || !in.next_float(y) || !in.next_float(z))  {
+            cerr << "ERROR: Malformed line " << in.line_number() << " in coordinates file " << coords_file << "." << endl; exit(1);
+        }
+        atoms.push_back(x, y, z);
+    }
+    return atoms;
+}
+
+
+// Cells are packed into a Key, 21 bits per axis. Cell coordinates start at 1
+// so that the cells around the first ones do not underflow.
+static inline Key cell_key(unsigned cx, unsigned cy, unsigned cz)  {
+    return ((Key) cx << 42) | ((Key) cy << 21) | (Key) cz;
+}
+
+// Distances are compared in single precision, like make_graph does on the
+// float32 coordinates of Biopython. sqrtf is monotonic, so comparing the
+// squared distance with the largest square whose root is <= threshold
+// gives the same edges without taking roots.
+static float squared_limit(float threshold)  {
+    if (!(threshold > 0.0))  {
+        cerr << "ERROR: Contact distance must be positive, but it is " << threshold << "." << endl; exit(1);
+    }
+
+    float limit = threshold * threshold;
+    while (sqrtf(limit) > threshold)
+        limit = nextafterf(limit, 0.0f);
+    while (sqrtf(nextafterf(limit, INFINITY)) <= threshold)
+        limit = nextafterf(limit, INFINITY);
+    return limit;
+}
+
+// Calls contact(i, j, d2) once for every pair of atoms whose squared distance
+// d2 is at most squared_limit(threshold).
+template <class Contact>
+static void for_each_contact(const AtomCoordinates &atoms, float threshold, Contact contact)  {
+    unsigned n = atoms.size();
+    float limit = squared_limit(threshold);
+    if (n == 0)
+        return;
+
+    float lo[3] = { atoms.x[0], atoms.y[0], atoms.z[0] };
+    for (unsigned i=0; i<n; i++)  {
+        lo[0] = min(lo[0], atoms.x[i]);
+        lo[1] = min(lo[1], atoms.y[i]);
+        lo[2] = min(lo[2], atoms.z[i]);
+    }
+
+    // Bin the atoms: cell of every atom, then atoms grouped by cell (counting sort).
+    FlatHashMap<unsigned> cells;
+    vector<unsigned> cell(n), cell_x(n), cell_y(n), cell_z(n), counts;
+    for (unsigned i=0; i<n; i++)  {
+        cell_x[i] = 1 + (unsigned) ((atoms.x[i] - lo[0]) / threshold);
+        cell_y[i] = 1 + (unsigned) ((atoms.y[i] - lo[1]) / threshold);
+        cell_z[i] = 1 + (unsigned) ((atoms.z[i] - lo[2]) / threshold);
+        if (max(cell_x[i], max(cell_y[i], cell_z[i])) >= (1U << 21) - 1)  {
+            cerr << "ERROR: Atom " << i << " is too far from the others for a contact distance of " << threshold << "." << endl; exit(1);
+        }
+
+        Key k = cell_key(cell_x[i], cell_y[i], cell_z[i]);
+        FlatHashMap<unsigned>::iterator it = cells.find(k);
+        if (it == cells.end())  {
+            cells[k] = counts.size();
+            counts.push_back(0);
+            cell[i] = counts.size() - 1;
+        }
+        else
+            cell[i] = it->second;
+        counts[cell[i]]++;
+    }
+
+    vector<unsigned> start(counts.size() + 1, 0), members(n);
+    for (unsigned c=0; c<counts.size(); c++)
+        start[c+1] = start[c] + counts[c];
+    for (unsigned i=0; i<n; i++)
+        members[start[cell[i]] + --counts[cell[i]]] = i;
+
+    // Every pair of atoms in the same or in adjacent cells is compared once:
+    // pairs within a cell, and all pairs with each adjacent cell of higher index.
+    vector<unsigned> around;
+    for (unsigned c=0; c<counts.size(); c++)  {
+        unsigned first = members[start[c]];
+        around.clear();
+        for (unsigned dx=0; dx<3; dx++)  {
+            for (unsigned dy=0; dy<3; dy++)  {
+                for (unsigned dz=0; dz<3; dz++)  {
+                    FlatHashMap<unsigned>::iterator it = cells.find(cell_key(cell_x[first] + dx - 1, cell_y[first] + dy - 1, cell_z[first] + dz - 1));
+                    if (it != cells.end() && it->second > c)
+                        around.push_back(it->second);
+                }
+            }
+        }
+
+        for (unsigned m=start[c]; m<start[c+1]; m++)  {
+            unsigned i = members[m];
+            float xi = atoms.x[i], yi = atoms.y[i], zi = atoms.z[i];
+            for (unsigned t=m+1; t<start[c+1]; t++)  {
+                unsigned j = members[t];
+                float ex = xi - atoms.x[j], ey = yi - atoms.y[j], ez = zi - atoms.z[j];
+                float d2 = ex * ex + ey * ey + ez * ez;
+                if (d2 <= limit)
+                    contact(i, j, d2);
+            }
+            for (unsigned a=0; a<around.size(); a++)  {
+                for (unsigned t=start[around[a]]; t<start[around[a]+1]; t++)  {
+                    unsigned j = members[t];
+                    float ex = xi - atoms.x[j], ey = yi - atoms.y[j], ez = zi - atoms.z[j];
+                    float d2 = ex * ex + ey * ey + ez * ez;
+                    if (d2 <= limit)
+                        contact(i, j, d2);
+                }
+            }
+        }
+    }
+}
+
+SimpleGraph contact_graph(const AtomCoordinates &atoms, const string &labels, float threshold)  {
+    unsigned n = atoms.size();
+    if (labels.size() != n)  {
+        cerr << "ERROR: " << labels.size() << " vertex labels for " << n << " atoms." << endl; exit(1);
+    }
+
+    SimpleGraph g;
+    g.nodes = labels;
+    g.adj.resize(n);
+    for_each_contact(atoms, threshold, [&](unsigned i, unsigned j, float)  {
+        g.adj[i].push_back(j);
+        g.adj[j].push_back(i);
+    });
+
+    for (unsigned i=0; i<n; i++)
+        sort(g.adj[i].begin(), g.adj[i].end());
+
+    g.index_edges();
+    return g;
+}
+
+
+vector<unsigned> read_residue_indices(const char *res_file)  {
+    ifstream in(res_file, ios::in);
+    if (in.fail())  {
+        cerr << "ERROR: Residue indices file " << res_file << " could not be opened." << endl; exit(1);
+    }
+
+    vector<unsigned> residues;
+    string field;
+    while (getline(in, field, ','))  {
+        field = strip(field);
+        if (field.empty())
+            continue;
+        if (field.find_first_not_of("0123456789") != string::npos)  {
+            cerr << "ERROR: Malformed residue index \"" << field << "\" in " << res_file << "." << endl; exit(1);
+        }
+        residues.push_back(to_i(field));
+    }
+    return residues;
+}
+
+
+static inline float squared_distance(const AtomCoordinates &atoms, unsigned i, unsigned j)  {
+    float dx = atoms.x[i] - atoms.x[j], dy = atoms.y[i] - atoms.y[j], dz = atoms.z[i] - atoms.z[j];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Rows of kept contacts, sorted, so that membership is a binary search.
+static inline bool in_row(const vector<vector<unsigned> > &rows, unsigned i, unsigned j)  {
+    return binary_search(rows[i].begin(), rows[i].end(), j);
+}
+
+void sparsify_contacts(SimpleGraph &g, const ContactPolicy &policy, const AtomCoordinates &atoms, const vector<unsigned> &residues)  {
+    unsigned n = g.adj.size();
+    if (policy.by_distance() && atoms.size() != n)  {
+        cerr << "ERROR: Limiting contacts by distance needs the coordinates of all " << n << " atoms, but there are " << atoms.size() << "." << endl; exit(1);
+    }
+    if (policy.min_separation > 0 && residues.size() != n)  {
+        cerr << "ERROR: Sequence separation needs the residue of all " << n << " atoms, but there are " << residues.size() << "." << endl; exit(1);
+    }
+
+    if (policy.min_separation > 0)  {
+        g.filter_edges([&](unsigned i, unsigned j)  {
+            unsigned separation = residues[i] > residues[j] ? residues[i] - residues[j] : residues[j] - residues[i];
+            bool covalent = (i + 1 == j || j + 1 == i) && separation <= 1;
+            return covalent || separation >= policy.min_separation;
+        });
+    }
+
+    // Ties in distance go to the lower atom id, so the result does not depend
+    // on the order of the adjacency lists.
+    if (policy.nearest > 0)  {
+        vector<vector<unsigned> > nearest(n);
+        vector<pair<float, unsigned> > row;
+        for (unsigned i=0; i<n; i++)  {
+            row.clear();
+            for (unsigned t=0; t<g.adj[i].size(); t++)
+                row.push_back(make_pair(squared_distance(atoms, i, g.adj[i][t]), g.adj[i][t]));
+            unsigned k = min<size_t>(policy.nearest, row.size());
+            partial_sort(row.begin(), row.begin() + k, row.end());
+            for (unsigned t=0; t<k; t++)
+                nearest[i].push_back(row[t].second);
+            sort(nearest[i].begin(), nearest[i].end());
+        }
+        g.filter_edges([&](unsigned i, unsigned j)  { return in_row(nearest, i, j) || in_row(nearest, j, i); });
+    }
+
+    if (policy.max_degree > 0)  {
+        vector<pair<float, pair<unsigned, unsigned> > > edges;
+        for (unsigned i=0; i<n; i++)  {
+            for (unsigned t=0; t<g.adj[i].size(); t++)  {
+                if (i < g.adj[i][t])
+                    edges.push_back(make_pair(squared_distance(atoms, i, g.adj[i][t]), make_pair(i, g.adj[i][t])));
+            }
+        }
+        sort(edges.begin(), edges.end());
+
+        vector<vector<unsigned> > kept(n);
+        for (size_t e=0; e<edges.size(); e++)  {
+            unsigned i = edges[e].second.first, j = edges[e].second.second;
+            if (kept[i].size() < policy.max_degree && kept[j].size() < policy.max_degree)  {
+                kept[i].push_back(j);
+                kept[j].push_back(i);
+            }
+        }
+        for (unsigned i=0; i<n; i++)
+            sort(kept[i].begin(), kept[i].end());
+        g.filter_edges([&](unsigned i, unsigned j)  { return in_row(kept, i, j); });
+    }
+}
+
+SimpleGraph contact_graph(const AtomCoordinates &atoms, const string &labels, float threshold, const ContactPolicy &policy, const vector<unsigned> &residues)  {
+    SimpleGraph g = contact_graph(atoms, labels, threshold);
+    if (!policy.empty())
+        sparsify_contacts(g, policy, atoms, residues);
+    return g;
+}
+
+
+// Position of a point on the Hilbert curve of order HILBERT_BITS through the
+// cube, from its cell coordinates (Skilling, "Programming the Hilbert curve").
+#define HILBERT_BITS 10
+static unsigned long long hilbert_index(unsigned x[3])  {
+    unsigned t;
+    for (unsigned q = 1U << (HILBERT_BITS - 1); q > 1; q >>= 1)  {
+        unsigned p = q - 1;
+        for (unsigned i=0; i<3; i++)  {
+            if (x[i] & q)
+                x[0] ^= p;
+            else  {
+                t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+    for (unsigned i=1; i<3; i++)
+        x[i] ^= x[i-1];
+    t = 0;
+    for (unsigned q = 1U << (HILBERT_BITS - 1); q > 1; q >>= 1)  {
+        if (x[2] & q)
+            t ^= q - 1;
+    }
+    for (unsigned i=0; i<3; i++)
+        x[i] ^= t;
+
+    unsigned long long index = 0;
+    for (int b=HILBERT_BITS-1; b>=0; b--)
+        for (unsigned i=0; i<3; i++)
+            index = (index << 1) | ((x[i] >> b) & 1);
+    return index;
+}
+
+vector<unsigned> hilbert_order(const AtomCoordinates &atoms)  {
+    unsigned n = atoms.size();
+    vector<unsigned> order(n);
+    if (n == 0)
+        return order;
+
+    float lo[3] = { atoms.x[0], atoms.y[0], atoms.z[0] }, hi[3] = { atoms.x[0], atoms.y[0], atoms.z[0] };
+    for (unsigned i=0; i<n; i++)  {
+        lo[0] = min(lo[0], atoms.x[i]);  hi[0] = max(hi[0], atoms.x[i]);
+        lo[1] = min(lo[1], atoms.y[i]);  hi[1] = max(hi[1], atoms.y[i]);
+        lo[2] = min(lo[2], atoms.z[i]);  hi[2] = max(hi[2], atoms.z[i]);
+    }
+    float extent = max(hi[0] - lo[0], max(hi[1] - lo[1], hi[2] - lo[2]));
+    float scale = extent > 0.0 ? ((1U << HILBERT_BITS) - 1) / extent : 0.0;
+
+    vector<pair<unsigned long long, unsigned> > keys(n);
+    for (unsigned i=0; i<n; i++)  {
+        unsigned cell[3] = { (unsigned) ((atoms.x[i] - lo[0]) * scale), (unsigned) ((atoms.y[i] - lo[1]) * scale), (unsigned) ((atoms.z[i] - lo[2]) * scale) };
+        keys[i] = make_pair(hilbert_index(cell), i);
+    }
+    sort(keys.begin(), keys.end());
+    for (unsigned i=0; i<n; i++)
+        order[i] = keys[i].second;
+    return order;
+}
+
+
+ContactDistances contact_distances(const AtomCoordinates &atoms, const string &labels, float max_threshold)  {
+    unsigned n = atoms.size();
+    if (labels.size() != n)  {
+        cerr << "ERROR: " << labels.size() << " vertex labels for " << n << " atoms." << endl; exit(1);
+    }
+
+    ContactDistances contacts;
+    contacts.labels = labels;
+    contacts.max_threshold = max_threshold;
+
+    // Pairs come out of the grid cell by cell: count them per atom, then
+    // scatter each pair into the rows of both atoms.
+    vector<unsigned> first, second;
+    vector<float> squares;
+    contacts.offsets.assign(n + 1, 0);
+    for_each_contact(atoms, max_threshold, [&](unsigned i, unsigned j, float d2)  {
+        first.push_back(i);
+        second.push_back(j);
+        squares.push_back(d2);
+        contacts.offsets[i+1]++;
+        contacts.offsets[j+1]++;
+    });
+    for (unsigned i=0; i<n; i++)
+        contacts.offsets[i+1] += contacts.offsets[i];
+
+    vector<size_t> fill(contacts.offsets.begin(), contacts.offsets.end() - 1);
+    vector<pair<float, unsigned> > row(2 * first.size());
+    for (size_t e=0; e<first.size(); e++)  {
+        row[fill[first[e]]++] = make_pair(squares[e], second[e]);
+        row[fill[second[e]]++] = make_pair(squares[e], first[e]);
+    }
+
+    // Nearest first; ties by index, so the lists do not depend on the order the grid finds the pairs.
+    contacts.neighbors.resize(row.size());
+    contacts.squares.resize(row.size());
+    for (unsigned i=0; i<n; i++)  {
+        sort(row.begin() + contacts.offsets[i], row.begin() + contacts.offsets[i+1]);
+        for (size_t e=contacts.offsets[i]; e<contacts.offsets[i+1]; e++)  {
+            contacts.squares[e] = row[e].first;
+            contacts.neighbors[e] = row[e].second;
+        }
+    }
+    return contacts;
+}
+
+
+SimpleGraph ContactDistances::graph(float threshold) const  {
+    if (threshold > max_threshold)  {
+        cerr << "ERROR: Contact distance " << threshold << " exceeds the " << max_threshold << " the distances were computed for." << endl; exit(1);
+    }
+
+    unsigned n = labels.size();
+    float limit = squared_limit(threshold);
+    SimpleGraph g;
+    g.nodes = labels;
+    g.adj.resize(n);
+    for (unsigned i=0; i<n; i++)  {
+        vector<float>::const_iterator end = upper_bound(squares.begin() + offsets[i], squares.begin() + offsets[i+1], limit);
+        g.adj[i].assign(neighbors.begin() + offsets[i], neighbors.begin() + (end - squares.begin()));
+        sort(g.adj[i].begin(), g.adj[i].end());
+    }
+
+    g.index_edges();
+    return g;
+}
@@ -0,0 +1,107 @@
+/**
+ * Contact graphs of protein atoms.
+ *
+ * Two atoms are in contact when their Euclidean distance is at most a
+ * threshold (7.5 A for the N/CA/C backbone graphs built by the pipeline).
+ * Atoms are binned into a uniform grid of cubic cells as wide as the
+ * threshold, so each atom is only compared with the atoms of the 27 cells
+ * around it. Only occupied cells are stored, in a hash table, so time and
+ * memory grow with the number of atoms and contacts, not with the volume
+ * of the bounding box.
+ *
+ * For sweeps over the threshold, contact_distances() finds the contacts up
+ * to the largest threshold once and sorts every atom's contacts by
+ * distance, so the graph of any smaller threshold is a prefix of each list.
+ *
+ * A ContactPolicy thins a contact graph to bound the degree of its atoms,
+ * and with it the cost of counting graphlets around them, at the price of
+ * dropping some long or local contacts.
+ *
+ */
+
+#ifndef __CONTACT_GRAPH_H__
+#define __CONTACT_GRAPH_H__
+
+#define CONTACT_THRESHOLD 7.5 // Default contact distance (A) between backbone atoms.
+
+#include "simgraph.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+
+/** Atom coordinates, one array per axis. */
+struct AtomCoordinates  {
+    vector<float> x, y, z;
+
+    inline size_t size() const  { return x.size(); }
+
+    inline void push_back(float ax, float ay, float az)  {
+        x.push_back(ax);
+        y.push_back(ay);
+        z.push_back(az);
+    }
+};
+
+
+/** Reads a coordinates file with one "x y z" line per atom, in the order of
+ *  the vertex labels. */
+AtomCoordinates read_coordinates(const char *coords_file);
+
+/** Builds the graph whose vertices are the atoms, labeled by labels, with an
+ *  edge between every two atoms at most threshold apart. Adjacency lists are
+ *  in increasing order, as in the graph files written by make_graph. */
+SimpleGraph contact_graph(const AtomCoordinates &atoms, const string &labels, float threshold);
+
+
+/** Limits on the contacts kept in a contact graph. Zero is no limit. */
+struct ContactPolicy  {
+    unsigned nearest;           // Keep a contact if it is one of the nearest contacts of either atom.
+    unsigned max_degree;        // Keep contacts shortest first while both atoms have fewer than max_degree.
+    unsigned min_separation;    // Drop contacts between residues fewer than min_separation apart in sequence, except covalent bonds.
+
+    ContactPolicy() : nearest(0), max_degree(0), min_separation(0)  {}
+
+    inline bool empty() const  { return nearest == 0 && max_degree == 0 && min_separation == 0; }
+    inline bool by_distance() const  { return nearest > 0 || max_degree > 0; }
+};
+
+/** Reads an .atom_res_indices file: the residue of every atom, comma-separated. */
+vector<unsigned> read_residue_indices(const char *res_file);
+
+/** Removes the edges of g that policy excludes: first those under the sequence
+ *  separation, then those beyond the nearest contacts, then those over the
+ *  degree limit. Vertex i is atom i, in residue residues[i]; atoms are only
+ *  needed for the distance limits, residues for the sequence separation.
+ *  Backbone atoms consecutive in the chain (N-CA, CA-C, C-N) are covalent. */
+void sparsify_contacts(SimpleGraph &g, const ContactPolicy &policy, const AtomCoordinates &atoms, const vector<unsigned> &residues);
+
+/** Same as contact_graph, with the contacts limited by policy. */
+SimpleGraph contact_graph(const AtomCoordinates &atoms, const string &labels, float threshold, const ContactPolicy &policy, const vector<unsigned> &residues);
+
+
+/** Order of the atoms along a 3D Hilbert curve through their bounding box:
+ *  order[v] is the atom to number v. Atoms close in space get close numbers,
+ *  for SimpleGraph::permuted. */
+vector<unsigned> hilbert_order(const AtomCoordinates &atoms);
+
+
+/** Contacts of every atom up to a maximum threshold, nearest first (CSR rows). */
+struct ContactDistances  {
+    string labels;
+    float max_threshold;
+    vector<size_t> offsets;     // Row of atom i is offsets[i] .. offsets[i+1]-1.
+    vector<unsigned> neighbors;
+    vector<float> squares;      // Squared distance to each neighbor, increasing within a row.
+
+    ContactDistances() : max_threshold(0.0)  {}
+
+    /** Builds the contact graph for threshold <= max_threshold from the prefixes
+     *  of the rows. Same graph as contact_graph() with that threshold. */
+    SimpleGraph graph(float threshold) const;
+};
+
+/** Finds the contacts of the atoms at most max_threshold apart, with their distances. */
+ContactDistances contact_distances(const AtomCoordinates &atoms, const string &labels, float max_threshold);
+
+#endif
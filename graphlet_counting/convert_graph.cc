@@ -0,0 +1,100 @@
+/**
+ * Converts a graph to a binary graph file (graph_file.h), which run_kernel
+ * reads with -g in place of the text graph and labels files.
+ *
+ * Usage: convert_graph -g G_FILE -l L_FILE [-Q MINSEP -i RES] -o OUTPUT
+ *        convert_graph -x COORDS -l L_FILE [-d DIST] [-K NEAREST] [-D MAXDEG] [-Q MINSEP -i RES] -o OUTPUT
+ *        convert_graph -P PDB [-d DIST] [-K NEAREST] [-D MAXDEG] [-Q MINSEP] -o OUTPUT
+ *
+ */
+
+#include "backbone.h"
+#include "contact_graph.h"
+#include "graph_file.h"
+#include "simgraph.h"
+#include "string.h"
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+
+void print_help()  {
+    cout << "Usage: convert_graph -g G_FILE -l L_FILE [-Q MINSEP -i RES] -o OUTPUT\n";
+    cout << "       convert_graph -x COORDS -l L_FILE [-d DIST] [-K NEAREST] [-D MAXDEG] [-Q MINSEP -i RES] -o OUTPUT\n";
+    cout << "       convert_graph -P PDB [-d DIST] [-K NEAREST] [-D MAXDEG] [-Q MINSEP] -o OUTPUT\n";
+    cout << "Options:\n\n";
+
+    cout << "  -h         Displays this message.\n\n";
+
+    cout << "  -g G_FILE  Input graph file.\n";
+    cout << "  -l L_FILE  Vertex labels file for input graph.\n";
+    cout << "  -x COORDS  Atom coordinates file (one \"x y z\" line per vertex label). Builds the contact graph instead of reading G_FILE.\n";
+    cout << "  -P PDB     Structure file (PDB, or mmCIF if named .cif). Builds the contact graph of the N, CA and C atoms of chain A.\n";
+    cout << "  -d DIST    Contact distance for the graph built from COORDS or PDB.\n";
+    cout << "             Defaults to 7.5.\n\n";
+
+    cout << "  -K NEAREST Keep only contacts among the NEAREST closest of either atom (COORDS or PDB).\n";
+    cout << "  -D MAXDEG  Keep contacts shortest first while both atoms have fewer than MAXDEG (COORDS or PDB).\n";
+    cout << "  -Q MINSEP  Drop contacts between residues fewer than MINSEP apart in sequence, except backbone bonds.\n";
+    cout << "  -i RES     Residue of every vertex (.atom_res_indices file), for -Q. Taken from PDB if not given.\n\n";
+
+    cout << "  -o OUTPUT  Output binary graph file.\n\n";
+}
+
+int main(int argc, char *argv[])  {
+    string g_file, l_file, coords_file, structure_file, residues_file, output_file;
+    float contact_distance(CONTACT_THRESHOLD);
+    ContactPolicy policy;
+
+    for (int i=1; i<argc; i++)  {
+        if (argv[i][0] != '-' || strlen(argv[i]) != 2 || (argv[i][1] != 'h' && i+1 >= argc))  {
+            cerr << "ERROR: Unknown option " << argv[i] << endl;
+            print_help();  exit(1);
+        }
+        switch (argv[i][1])  {
+            case 'h': print_help(); exit(0);
+            case 'g': g_file = argv[++i]; break;
+            case 'l': l_file = argv[++i]; break;
+            case 'x': coords_file = argv[++i]; break;
+            case 'P': structure_file = argv[++i]; break;
+            case 'd': contact_distance = to_f(argv[++i]); break;
+            case 'K': policy.nearest = to_i(argv[++i]); break;
+            case 'D': policy.max_degree = to_i(argv[++i]); break;
+            case 'Q': policy.min_separation = to_i(argv[++i]); break;
+            case 'i': residues_file = argv[++i]; break;
+            case 'o': output_file = argv[++i]; break;
+            default:
+                cerr << "ERROR: Unknown option " << argv[i] << endl;
+                print_help();  exit(1);
+        }
+    }
+
+    if (0 == output_file.size())  {
+        cerr << "ERROR: Output file name not specified." << endl;  print_help();  exit(1);
+    }
+
+    vector<unsigned> residues;
+    if (residues_file.size() > 0)
+        residues = read_residue_indices(residues_file.c_str());
+
+    SimpleGraph g;
+    if (structure_file.size() > 0)  {
+        Backbone backbone = read_backbone(structure_file.c_str());
+        if (residues_file.size() == 0)
+            residues = backbone.residue_indices;
+        g = contact_graph(backbone.atoms, backbone.labels, contact_distance, policy, residues);
+    }
+    else if (coords_file.size() > 0)
+        g = contact_graph(read_coordinates(coords_file.c_str()), SimpleGraph::read_labels(l_file.c_str()), contact_distance, policy, residues);
+    else if (g_file.size() > 0)  {
+        g = SimpleGraph::read_graph(l_file.c_str(), g_file.c_str());
+        if (!policy.empty())
+            sparsify_contacts(g, policy, AtomCoordinates(), residues);
+    }
+    else  {
+        cerr << "ERROR: Input graph not specified." << endl;  print_help();  exit(1);
+    }
+
+    write_graph_file(output_file.c_str(), g);
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include "feature_vocabulary.h"
+#include "text_reader.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+
+bool FeatureVocabulary::read(const char *file)  {
+    TextReader in;
+    if (!in.open(file))
+        return false;
+
+    columns.clear();
+    while (in.next_line())  {
+        Key id;
+        in.next_unsigned(id);
+        if (columns.find(id) != columns.end())  {
+            cerr << "ERROR: Feature " << id << " is repeated in line " << in.line_number() << " of vocabulary " << file << "." << endl; exit(1);
+        }
+        unsigned c = columns.size();
+        columns[id] = c;
+    }
+    return true;
+}
+
+
+void FeatureVocabulary::write(const char *file) const  {
+    ofstream out(file, ios::out);
+    if (out.fail())  {
+        cerr << "ERROR: Vocabulary file " << file << " could not be created." << endl; exit(1);
+    }
+    for (FlatHashMap<unsigned>::const_iterator it = columns.begin(); it != columns.end(); it++)
+        out << it->first << '\n';
+
+    out.close();
+    if (out.fail())  {
+        cerr << "ERROR: Vocabulary file " << file << " could not be written." << endl; exit(1);
+    }
+}
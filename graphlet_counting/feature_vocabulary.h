@@ -0,0 +1,57 @@
+/**
+ * Persistent numbering of graphlet feature ids as dense columns.
+ *
+ * Feature ids (get_feature_id) are sparse 30+ bit numbers. A vocabulary
+ * gives every id seen so far a column 0..F-1 in order of first appearance,
+ * so feature matrices of different runs share their columns, and a model
+ * trained on them can be applied to new structures without remapping.
+ *
+ * File format: text, one feature id per line; line c (from 0) is column c.
+ *
+ */
+
+#ifndef __FEATURE_VOCABULARY_H__
+#define __FEATURE_VOCABULARY_H__
+
+#include "config.h"
+#include "flat_hash.h"
+#include <climits>
+#include <vector>
+using namespace std;
+
+#define NO_COLUMN UINT_MAX
+
+
+class FeatureVocabulary  {
+public:
+    FeatureVocabulary() : frozen(false)  {}
+
+    /** Reads the columns of a vocabulary file; returns false if it does not exist. */
+    bool read(const char *file);
+
+    /** Writes the vocabulary file. */
+    void write(const char *file) const;
+
+    /** Column of feature id. New ids get the next column, or NO_COLUMN if frozen. */
+    inline unsigned column(Key id)  {
+        FlatHashMap<unsigned>::iterator it = columns.find(id);
+        if (it != columns.end())
+            return it->second;
+        if (frozen)
+            return NO_COLUMN;
+        unsigned c = columns.size();
+        columns[id] = c;
+        return c;
+    }
+
+    /** Stops adding columns, e.g. to keep those a model was trained on. */
+    inline void freeze()  { frozen = true; }
+
+    inline size_t size() const  { return columns.size(); }
+
+private:
+    FlatHashMap<unsigned> columns;  // In column order.
+    bool frozen;
+};
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * Flat open-addressing hash table for graphlet keys.
+ *
+ * Entries are stored contiguously in a vector (iteration order) and a
+ * power-of-two slot array with linear probing maps keys to entries, so a
+ * lookup touches one or two cache lines instead of walking a red-black
+ * tree. The interface mirrors the subset of std::map used by the graphlet
+ * counting code (find, operator[], begin/end, size, clear), and iterators
+ * dereference to pair<Key,V> so it->first / it->second keep working.
+ *
+ * Unlike std::map, iteration order is insertion order until sort_by_key()
+ * is called. Inserting invalidates iterators and references, so the table
+ * must not be modified while it is being iterated.
+ *
+ */
+
+#ifndef __FLAT_HASH_H__
+#define __FLAT_HASH_H__
+
+#include "config.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+using namespace std;
+
+
+template <class V>
+class FlatHashMap  {
+public:
+    typedef pair<Key,V> value_type;
+    typedef typename vector<value_type>::iterator iterator;
+    typedef typename vector<value_type>::const_iterator const_iterator;
+
+    FlatHashMap() : mask(0)  {}
+    ~FlatHashMap()  {}
+
+    inline iterator begin()  { return entries.begin(); }
+    inline iterator end()  { return entries.end(); }
+    inline const_iterator begin() const  { return entries.begin(); }
+    inline const_iterator end() const  { return entries.end(); }
+
+    inline size_t size() const  { return entries.size(); }
+    inline bool empty() const  { return entries.empty(); }
+
+    inline void clear()  {
+        entries.clear();
+        slots.clear();
+        mask = 0;
+    }
+
+    /** Makes room for n entries without rehashing. */
+    void reserve(size_t n)  {
+        entries.reserve(n);
+        if (2 * n > slots.size())
+            rehash(2 * n);
+    }
+
+    iterator find(const Key &k)  {
+        if (entries.empty())
+            return entries.end();
+        for (size_t s = slot_of(k); slots[s] != 0; s = (s + 1) & mask)  {
+            if (entries[slots[s]-1].first == k)
+                return entries.begin() + (slots[s]-1);
+        }
+        return entries.end();
+    }
+
+    const_iterator find(const Key &k) const  {
+        if (entries.empty())
+            return entries.end();
+        for (size_t s = slot_of(k); slots[s] != 0; s = (s + 1) & mask)  {
+            if (entries[slots[s]-1].first == k)
+                return entries.begin() + (slots[s]-1);
+        }
+        return entries.end();
+    }
+
+    /** Returns the value for key k, inserting a value-initialized one if missing. */
+    V &operator[](const Key &k)  {
+        if (2 * (entries.size() + 1) > slots.size())
+            rehash(2 * (entries.size() + 1));
+
+        size_t s = slot_of(k);
+        for (; slots[s] != 0; s = (s + 1) & mask)  {
+            if (entries[slots[s]-1].first == k)
+                return entries[slots[s]-1].second;
+        }
+        entries.push_back(value_type(k, V()));
+        slots[s] = entries.size();
+        return entries.back().second;
+    }
+
+    /** Reorders the entries by increasing key (the iteration order of std::map). */
+    void sort_by_key()  {
+        sort(entries.begin(), entries.end(), compare_keys);
+        rehash(slots.size());
+    }
+
+private:
+    static inline bool compare_keys(const value_type &a, const value_type &b)  {
+        return a.first < b.first;
+    }
+
+    // Fibonacci hashing; keys are packed labels, so their low bits are not well spread.
+    inline size_t slot_of(const Key &k) const  {
+        return (size_t) ((k * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    }
+
+    void rehash(size_t n)  {
+        size_t capacity = 16;
+        while (capacity < n)
+            capacity <<= 1;
+
+        slots.assign(capacity, 0);
+        mask = capacity - 1;
+        for (size_t e=0; e<entries.size(); e++)  {
+            size_t s = slot_of(entries[e].first);
+            while (slots[s] != 0)
+                s = (s + 1) & mask;
+            slots[s] = e + 1;
+        }
+    }
+
+    vector<value_type> entries; // Dense storage, iteration order.
+    vector<unsigned> slots;     // Index+1 into entries, 0 marks an empty slot.
+    size_t mask;
+};
+
+
+typedef FlatHashMap<MismatchInfo> MismatchHash;
+
+#endif
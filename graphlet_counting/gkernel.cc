@@ -1,5 +1,7 @@
 #include "gkernel.h"
+#include "npy_file.h"
 #include "string.h"
+#include "text_reader.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -7,11 +9,125 @@
 #include <iomanip>
 
 
+/*********************** LabelRows methods ***********************/
+
+// Bits set in x & y (& z), over words 64-bit words.
+static inline unsigned count_common(const unsigned long long *x, const unsigned long long *y, size_t words)  {
+    unsigned n = 0;
+    for (size_t w=0; w<words; w++)
+        n += __builtin_popcountll(x[w] & y[w]);
+    return n;
+}
+
+static inline unsigned count_common(const unsigned long long *x, const unsigned long long *y, const unsigned long long *z, size_t words)  {
+    unsigned n = 0;
+    for (size_t w=0; w<words; w++)
+        n += __builtin_popcountll(x[w] & y[w] & z[w]);
+    return n;
+}
+
+void LabelRows::build(const SimpleGraph &g, const vector<unsigned> &dist)  {
+    if (index_of.empty())
+        index_of.assign(UCHAR_MAX + 1, -1);
+    for (unsigned c=0; c<labels.size(); c++)
+        index_of[(unsigned char) labels[c]] = -1;
+    labels.clear();
+    for (unsigned v=0; v<g.nodes.size(); v++)  {
+        unsigned char l = g.nodes[v];
+        if (index_of[l] < 0)  {
+            index_of[l] = labels.size();
+            labels += g.nodes[v];
+        }
+    }
+
+    words = g.bit_row_words();
+    rows.assign(labels.size() * words, 0);
+    second.assign(words, 0);
+    for (unsigned v=0; v<g.nodes.size(); v++)  {
+        rows[label_index(g.nodes[v]) * words + (v >> 6)] |= 1ULL << (v & 63);
+        if (dist[v] == 2)
+            second[v >> 6] |= 1ULL << (v & 63);
+    }
+    passed.assign(words, 0);
+    passed_count.assign(labels.size(), 0);
+    passed_labels.clear();
+    second_of.assign(labels.size() * words, 0);
+    second_count.assign(labels.size(), 0);
+    second_labels.clear();
+    // add_second leaves the tally zeroed.
+    if (tally.size() < 4 * labels.size() * labels.size())
+        tally.resize(4 * labels.size() * labels.size(), 0);
+}
+
+void LabelRows::add_triangles(GraphletBuffer &graphlets, const SimpleGraph &g, unsigned i) const  {
+    char a = g.nodes[i];
+    for (unsigned b_=0; b_<passed_labels.size(); b_++)  {
+        unsigned b = passed_labels[b_];
+        unsigned closed = count_common(&passed[0], g.bit_row(i), &rows[b * words], words);
+        graphlets.add(4, a, labels[b], ZERO_CHAR, ZERO_CHAR, closed);
+        graphlets.add(3, a, labels[b], ZERO_CHAR, ZERO_CHAR, passed_count[b] - closed);
+    }
+}
+
+void LabelRows::select_second(const SimpleGraph &g, unsigned i)  {
+    for (unsigned c_=0; c_<second_labels.size(); c_++)  {
+        unsigned c = second_labels[c_];
+        fill(&second_of[c * words], &second_of[(c + 1) * words], 0);
+        second_count[c] = 0;
+    }
+    second_labels.clear();
+
+    // Split the neighbors of i at distance 2 by label, one set bit at a time.
+    const unsigned long long *row_i = g.bit_row(i);
+    for (size_t w=0; w<words; w++)  {
+        for (unsigned long long x = row_i[w] & second[w]; x != 0; x &= x - 1)  {
+            unsigned v = w * 64 + __builtin_ctzll(x);
+            unsigned c = label_index(g.nodes[v]);
+            second_of[c * words + w] |= x & -x;
+            if (second_count[c]++ == 0)
+                second_labels.push_back(c);
+        }
+    }
+}
+
+void LabelRows::count_second(const SimpleGraph &g, unsigned j, bool found_ij, bool cycles)  {
+    unsigned n = labels.size();
+    unsigned closed = ((found_ij ? 0 : 2) * n + label_index(g.nodes[j])) * n;
+    unsigned open = closed + n * n;
+    for (unsigned c_=0; c_<second_labels.size(); c_++)  {
+        unsigned c = second_labels[c_];
+        unsigned found = count_common(&second_of[c * words], g.bit_row(j), words);
+        if (cycles && found > 0)
+            tally_add(closed + c, found);
+        if (second_count[c] > found)
+            tally_add(open + c, second_count[c] - found);
+    }
+}
+
+void LabelRows::add_second(GraphletBuffer &graphlets, char a)  {
+    // Tally blocks in orbit order: cycles and paths with i-j adjacent, then without.
+    static const unsigned long orbits[4] = {13, 11, 12, 6};
+    unsigned n = labels.size();
+    for (unsigned t=0; t<tallied.size(); t++)  {
+        unsigned o = tallied[t] / (n * n), b = tallied[t] / n % n, c = tallied[t] % n;
+        if (o % 2 == 0)
+            graphlets.add(orbits[o], a, labels[b], labels[c], ZERO_CHAR, tally[tallied[t]]);
+        else
+            graphlets.add(orbits[o], labels[b], a, labels[c], ZERO_CHAR, tally[tallied[t]]);
+        tally[tallied[t]] = 0;
+    }
+    tallied.clear();
+}
+
+
 /*********************** GraphKernel methods ***********************/
 void GraphKernel::read_graphs(string nlabels_file, string graph_file, const vector<unsigned> &vertices)  {
     if (VERBOSE)  cerr << "Reading input data ... ";
 
-    graph = SimpleGraph::read_graph(nlabels_file.c_str(), graph_file.c_str());
+    if (GraphFile::is_graph_file(graph_file.c_str()))
+        graph = read_graph_file(graph_file.c_str());
+    else
+        graph = SimpleGraph::read_graph(nlabels_file.c_str(), graph_file.c_str());
 
     for (unsigned i=0; i<vertices.size(); i++)  {
         if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
@@ -20,32 +136,185 @@ void GraphKernel::read_graphs(string nlabels_file, string graph_file, const vect
     }
 
     if (VERBOSE)  cerr << endl;
+
+    if (ORDER == ORDER_HILBERT || ROOT_ORDER == ROOTS_SPATIAL)  {
+        cerr << "ERROR: Hilbert curve order needs atom coordinates; build the contact graph from coordinates or a structure file." << endl; exit(1);
+    }
+    sparsify_graph(AtomCoordinates());
+    renumber_vertices();
+}
+
+void GraphKernel::read_contact_graph(const AtomCoordinates &atoms, const string &nlabels, float threshold, const vector<unsigned> &vertices)  {
+    if (VERBOSE)  cerr << "Building contact graph ... ";
+
+    graph = contact_graph(atoms, nlabels, threshold);
+    roots.insert(roots.end(), vertices.begin(), vertices.end());
+
+    if (VERBOSE)  cerr << graph.adj.size() << " atoms" << endl;
+
+    if (ORDER == ORDER_HILBERT || ROOT_ORDER == ROOTS_SPATIAL)
+        atom_order = hilbert_order(atoms);
+    sparsify_graph(atoms);
+    renumber_vertices();
+}
+
+void GraphKernel::read_contact_distances(const AtomCoordinates &atoms, const string &nlabels, float max_threshold, const vector<unsigned> &vertices)  {
+    if (VERBOSE)  cerr << "Finding contacts up to " << max_threshold << " ... ";
+
+    contacts = contact_distances(atoms, nlabels, max_threshold);
+    roots.insert(roots.end(), vertices.begin(), vertices.end());
+
+    if (VERBOSE)  cerr << contacts.labels.size() << " atoms" << endl;
+
+    if (ORDER == ORDER_HILBERT || ROOT_ORDER == ROOTS_SPATIAL)
+        atom_order = hilbert_order(atoms);
+    if (policy.by_distance())
+        contact_atoms = atoms;
+}
+
+// Searches and counts of the previous threshold do not carry over to the new graph.
+void GraphKernel::set_contact_threshold(float threshold)  {
+    if (VERBOSE)  cerr << "Contact distance " << threshold << endl;
+
+    graph = contacts.graph(threshold);
+    sparsify_graph(contact_atoms);
+    renumber_vertices();
+    root_batches.clear();
+    root_batch_slot.clear();
+    root_sequence.clear();
+    hashes.clear();
+}
+
+static size_t edge_count(const SimpleGraph &g)  {
+    size_t entries = 0;
+    for (unsigned i=0; i<g.adj.size(); i++)
+        entries += g.adj[i].size();
+    return entries / 2;
+}
+
+void GraphKernel::sparsify_graph(const AtomCoordinates &atoms)  {
+    if (policy.empty())
+        return;
+
+    size_t before = edge_count(graph);
+    sparsify_contacts(graph, policy, atoms, residues);
+    if (VERBOSE)  cerr << "Kept " << edge_count(graph) << " of " << before << " contacts" << endl;
+}
+
+// The Hilbert order depends only on the atoms and is kept across thresholds;
+// the RCM order is recomputed for every graph.
+void GraphKernel::renumber_vertices()  {
+    if (ORDER == ORDER_FILE)
+        return;
+
+    if (ORDER == ORDER_RCM)
+        vertex_order = graph.rcm_order();
+    else if (ORDER == ORDER_HILBERT)
+        vertex_order = atom_order;
+    if (vertex_order.size() != graph.adj.size())  {
+        cerr << "ERROR: Vertex order has " << vertex_order.size() << " vertices, graph has " << graph.adj.size() << "." << endl; exit(1);
+    }
+    graph = graph.permuted(vertex_order);
+
+    if (input_roots.empty())
+        input_roots = roots;
+    vector<unsigned> rank(vertex_order.size());
+    for (unsigned v=0; v<vertex_order.size(); v++)
+        rank[vertex_order[v]] = v;
+    for (unsigned i=0; i<input_roots.size(); i++)  {
+        if (input_roots[i] >= rank.size())  {
+            cerr << "ERROR: Vertex of interest " << input_roots[i] << " >= graph size " << rank.size() << "." << endl; exit(1);
+        }
+        roots[i] = rank[input_roots[i]];
+    }
+}
+
+// Roots are sorted by the position of their vertex in a breadth-first or
+// space-filling order of the graph; repeated roots keep their input order.
+void GraphKernel::sequence_roots()  {
+    unsigned n = graph.adj.size();
+    root_sequence.resize(roots.size());
+    for (unsigned i=0; i<roots.size(); i++)  {
+        if (roots[i] >= n)  {
+            cerr << "ERROR: Vertex of interest " << roots[i] << " >= graph size " << n << "." << endl; exit(1);
+        }
+        root_sequence[i] = i;
+    }
+    if (ROOT_ORDER == ROOTS_INPUT)
+        return;
+
+    vector<unsigned> rank(n);
+    if (ROOT_ORDER == ROOTS_BFS)  {
+        vector<unsigned> order = graph.rcm_order();
+        for (unsigned v=0; v<n; v++)
+            rank[order[v]] = v;
+    }
+    else  {
+        if (atom_order.size() != n)  {
+            cerr << "ERROR: Spatial root order has " << atom_order.size() << " atoms, graph has " << n << "." << endl; exit(1);
+        }
+        // atom_order is in input ids; the graph may have been renumbered since.
+        vector<unsigned> input_rank(n);
+        for (unsigned k=0; k<n; k++)
+            input_rank[atom_order[k]] = k;
+        for (unsigned v=0; v<n; v++)
+            rank[v] = input_rank[vertex_order.empty() ? v : vertex_order[v]];
+    }
+    stable_sort(root_sequence.begin(), root_sequence.end(), [&](unsigned i, unsigned j)  { return rank[roots[i]] < rank[roots[j]]; });
+}
+
+vector<double> GraphKernel::sequence_costs(const vector<double> &costs)  {
+    vector<double> sequenced(root_sequence.size());
+    for (unsigned k=0; k<root_sequence.size(); k++)
+        sequenced[k] = costs[root_sequence[k]];
+    return sequenced;
+}
+
+// Roots listed as input are balanced by cost. A BFS or spatial order is kept:
+// every thread walks a contiguous stretch of root_sequence, and of the batched
+// searches, so consecutive roots on a thread share their neighborhoods.
+void GraphKernel::run_sequenced(WorkStealingScheduler &scheduler, const vector<double> &costs, const function<void(unsigned)> &task)  {
+    if (ROOT_ORDER == ROOTS_INPUT)
+        scheduler.run(sequence_costs(costs), task);
+    else
+        scheduler.run_in_order(sequence_costs(costs), task);
 }
 
 void GraphKernel::read_sim_matrix(string sim_matrix_file)  {
     if (VERBOSE)  cerr << "Reading probability similarity matrix for vertex labels file ... ";
-    string column, row, key;
+    string column, key;
 	
-    // Read vertex labels similarity matrix.
-    ifstream p(sim_matrix_file.c_str(), ios::in);
-    if (p.fail()) {
+    // Read vertex labels similarity matrix: a line with the column labels, then
+    // one line per row label with a similarity for each column.
+    TextReader p;
+    if (!p.open(sim_matrix_file.c_str())) {
         cerr << "ERROR: Vertex labels similarity matrix file " << sim_matrix_file << " cannot be opened." << endl; exit(1);
     }
     else  {
         if (VERBOSE)  cerr << sim_matrix_file.c_str();
-        getline(p, column);
-        while(getline(p, row))  {
-            vector<string> tokens = split(row, '\t'); 
-            for(unsigned i=0 ; i<column.size() ; i++)  {
-                key = tokens[0] + column[i];
+        const char *begin, *end;
+        if (p.next_line())  {
+            while (p.next_field(begin, end))
+                column.append(begin, end);
+        }
+        while (p.next_line())  {
+            p.next_field(begin, end);
+            key.assign(begin, end);
+            size_t row_length = key.size();
+            for (unsigned i=0 ; i<column.size() ; i++)  {
+                float similarity;
+                if (!p.next_float(similarity))  {
+                    cerr << "ERROR: Missing similarities in line " << p.line_number() << " of vertex labels similarity matrix file " << sim_matrix_file << "." << endl; exit(1);
+                }
+                key.resize(row_length);
+                key.push_back(column[i]);
                 map<string, float>::iterator it = sim_vlm_matrix.find(key);
                 if(it == sim_vlm_matrix.end())  {
-                    sim_vlm_matrix[key] = to_f(tokens[i+1]);
+                    sim_vlm_matrix[key] = similarity;
                 }
             }
         }
     }
-    p.close();
 
     if (VERBOSE)  cerr << endl;
 }
@@ -94,6 +363,8 @@ void GraphKernel::compute_label_mismatch_matrix()  {
             cerr << "Computing Standard Graphlet Kernel ... ";
     }
 
+    WorkStealingScheduler scheduler(THREADS);
+
     kernel.resize(roots.size());
     for (unsigned i=0; i<roots.size(); i++)
         kernel[i].resize(i+1);
@@ -103,29 +374,31 @@ void GraphKernel::compute_label_mismatch_matrix()  {
 			kernel[i][j] = 0.0;
 	}
 
-    for (unsigned i=0; i<roots.size(); i++)  {
-        hashes.push_back(get_graphlets_counts(graph, roots[i]));
-    }
+    count_root_graphlets(scheduler);
 
 	unsigned long g_type = 0;
 	while (g_type < GRAPHLET_TYPES)  {
         if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
             int VLM = set_k(g_type, SF);
-            map<Key,MismatchInfo> mismatch_hash;            
-            
-		    for (unsigned i=0; i<roots.size(); i++)  {
-			    if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
-                
-                add_vertex_label_mismatch_counts(hashes[i][g_type], mismatch_hash, g_type, VLM, false);
+
+            // Add inexact graphlets of every root before joining any pair of roots.
+            scheduler.run(root_costs(), [&](unsigned i)  {
+                MismatchHash mismatch_hash;
+                map<Key, list<Key> > vl_mismatch_neighborhood;
+
+                add_vertex_label_mismatch_counts(hashes[i][g_type], mismatch_hash, vl_mismatch_neighborhood, g_type, VLM, false);
 
                 update_label_mismatch_counts(hashes[i][g_type], mismatch_hash, g_type, false, VLM, false);
+            });
+
+            scheduler.run(row_costs(), [&](unsigned i)  {
+			    if (VERBOSE && (i+1) % 100 == 0)  cerr << (" " + to_s(i+1));
 
 			    kernel[i][i] = kernel[i][i] + distance_hash_join(hashes[i][g_type], hashes[i][g_type], g_type);
 			    for (unsigned j=0; j<i; j++)  {
 				    kernel[i][j] = kernel[i][j] + distance_hash_join(hashes[i][g_type], hashes[j][g_type], g_type);
 			    }
-		    }
-			vl_mismatch_neighborhood.clear();
+		    });
 
 			for (unsigned i=0; i<roots.size(); i++)  {
 				hashes[i][g_type].clear();
@@ -140,23 +413,25 @@ void GraphKernel::compute_label_mismatch_matrix()  {
 void GraphKernel::compute_edge_mismatch_matrix()  {
     if (VERBOSE)   cerr << "Computing Edge Indels Graphlet Kernel ... ";
 
+    WorkStealingScheduler scheduler(THREADS);
+
     kernel.resize(roots.size());
     for (unsigned i=0; i<roots.size(); i++)
         kernel[i].resize(i+1);
 
-    for (unsigned i=0; i<roots.size(); i++)  {
-        hashes.push_back(get_graphlets_counts(graph, roots[i]));
+    count_root_graphlets(scheduler);
+    scheduler.run(root_costs(), [&](unsigned i)  {
         add_edge_mismatch_counts(hashes[i]);
-    }
+    });
 
-    for (unsigned i=0; i<roots.size(); i++)  {
-        if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
+    scheduler.run(row_costs(), [&](unsigned i)  {
+        if (VERBOSE && (i+1) % 100 == 0)  cerr << (" " + to_s(i+1));
         
         kernel[i][i] = distance_hash_join(hashes[i], hashes[i]);
         for (unsigned j=0; j<i; j++)  {
             kernel[i][j] = distance_hash_join(hashes[i], hashes[j]);
         }
-    }
+    });
 
     if (VERBOSE)  cerr << endl;
 }
@@ -164,6 +439,8 @@ void GraphKernel::compute_edge_mismatch_matrix()  {
 void GraphKernel::compute_edit_distance_matrix()  {
     if (VERBOSE)  cerr << "Computing Edit Distance Graphlet Kernel (d=1) ... ";
 
+    WorkStealingScheduler scheduler(THREADS);
+
     kernel.resize(roots.size());
     for (unsigned i=0; i<roots.size(); i++)
         kernel[i].resize(i+1);
@@ -173,32 +450,35 @@ void GraphKernel::compute_edit_distance_matrix()  {
 			kernel[i][j] = 0.0;
 	}
 
-    for (unsigned i=0; i<roots.size(); i++)  {
-        hashes.push_back(get_graphlets_counts(graph, roots[i]));
+    count_root_graphlets(scheduler);
+    scheduler.run(root_costs(), [&](unsigned i)  {
         add_edge_mismatch_counts(hashes[i]);
-    }
+    });
 
 	unsigned long g_type = 0;
 	while (g_type < GRAPHLET_TYPES)  {
         if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
             int VLM = set_k(g_type, SF);
-            map<Key,MismatchInfo> mismatch_hash;
 
-		    for (unsigned i=0; i<roots.size(); i++)  {
-			    if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
-                
+            scheduler.run(root_costs(), [&](unsigned i)  {
+                MismatchHash mismatch_hash;
+                map<Key, list<Key> > vl_mismatch_neighborhood;
+
                 if (VLM >= 1)  {
-                    add_vertex_label_mismatch_counts(hashes[i][g_type], mismatch_hash, g_type, 1, false);
+                    add_vertex_label_mismatch_counts(hashes[i][g_type], mismatch_hash, vl_mismatch_neighborhood, g_type, 1, false);
                 }
 
                 update_label_mismatch_counts(hashes[i][g_type], mismatch_hash, g_type, false, 1, true);
+            });
+
+            scheduler.run(row_costs(), [&](unsigned i)  {
+			    if (VERBOSE && (i+1) % 100 == 0)  cerr << (" " + to_s(i+1));
 
 			    kernel[i][i] = kernel[i][i] + distance_hash_join(hashes[i][g_type], hashes[i][g_type], g_type);
 			    for (unsigned j=0; j<i; j++)  {
 				    kernel[i][j] = kernel[i][j] + distance_hash_join(hashes[i][g_type], hashes[j][g_type], g_type);
 			    }
-		    }
-			vl_mismatch_neighborhood.clear();
+		    });
 
             for (unsigned i=0; i<roots.size(); i++)  {
                 hashes[i][g_type].clear();
@@ -213,6 +493,8 @@ void GraphKernel::compute_edit_distance_matrix()  {
 void GraphKernel::compute_edit_distance2_matrix()  {
     if (VERBOSE)  cerr << "Computing Edit Distance Graphlet Kernel (d=2) ... ";
 
+    WorkStealingScheduler scheduler(THREADS);
+
     kernel.resize(roots.size());
     for (unsigned i=0; i<roots.size(); i++)
         kernel[i].resize(i+1);
@@ -222,53 +504,57 @@ void GraphKernel::compute_edit_distance2_matrix()  {
 			kernel[i][j] = 0.0;
 	}
 
-    for (unsigned i=0; i<roots.size(); i++)  {
-        hashes.push_back(get_graphlets_counts(graph, roots[i]));
+    count_root_graphlets(scheduler);
+    scheduler.run(root_costs(), [&](unsigned i)  {
         add_1_edge_mismatch_counts(hashes[i]);
-    }
+    });
 
 	unsigned long g_type = 0;
 	while (g_type < GRAPHLET_TYPES)  {
         if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
             int VLM = set_k(g_type, SF);
-            map<Key,MismatchInfo> mismatch_hash;
 
-		    for (unsigned i=0; i<roots.size(); i++)  {
+            scheduler.run(root_costs(), [&](unsigned i)  {
+                MismatchHash mismatch_hash;
+                map<Key, list<Key> > vl_mismatch_neighborhood;
+
                 if (VLM >= 1)  {
-                    add_vertex_label_mismatch_counts(hashes[i][g_type], mismatch_hash, g_type, 1, true);
+                    add_vertex_label_mismatch_counts(hashes[i][g_type], mismatch_hash, vl_mismatch_neighborhood, g_type, 1, true);
                 }
                
                 update_label_mismatch_counts(hashes[i][g_type], mismatch_hash, g_type, true, 1, true);
-            }
+            });
         }
-		vl_mismatch_neighborhood.clear();
         g_type = g_type + 1;
     }
-    for (unsigned i=0; i<roots.size(); i++)  {
+    scheduler.run(root_costs(), [&](unsigned i)  {
         add_2_edge_mismatch_counts(hashes[i]);
-    }
+    });
 
 	g_type = 0;
 	while (g_type < GRAPHLET_TYPES)  {
         if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
             int VLM = set_k(g_type, SF);
-            map<Key,MismatchInfo> mismatch_hash;
 
-            for (unsigned i=0; i<roots.size(); i++)  {
-                if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
+            scheduler.run(root_costs(), [&](unsigned i)  {
+                MismatchHash mismatch_hash;
+                map<Key, list<Key> > vl_mismatch_neighborhood;
 
                 if (VLM >= 2)  {
-                    add_vertex_label_mismatch_counts(hashes[i][g_type], mismatch_hash, g_type, 2, false);
+                    add_vertex_label_mismatch_counts(hashes[i][g_type], mismatch_hash, vl_mismatch_neighborhood, g_type, 2, false);
                 }
 
                 update_label_mismatch_counts(hashes[i][g_type], mismatch_hash, g_type, false, 2, true);
+            });
+
+            scheduler.run(row_costs(), [&](unsigned i)  {
+                if (VERBOSE && (i+1) % 100 == 0)  cerr << (" " + to_s(i+1));
 
                 kernel[i][i] = kernel[i][i] + distance_hash_join(hashes[i][g_type], hashes[i][g_type], g_type);
 			    for (unsigned j=0; j<i; j++)  {
 				    kernel[i][j] = kernel[i][j] + distance_hash_join(hashes[i][g_type], hashes[j][g_type], g_type);
 			    }
-		    }
-			vl_mismatch_neighborhood.clear();
+		    });
 
             for (unsigned i=0; i<roots.size(); i++)  {
                 hashes[i][g_type].clear();
@@ -279,6 +565,106 @@ void GraphKernel::compute_edit_distance2_matrix()  {
     if (VERBOSE)  cerr << endl;
 }
 
+// Count graphlets around every root into hashes. Roots too heavy to be balanced
+// by the scheduler are counted one at a time, each split across all threads.
+void GraphKernel::count_root_graphlets(WorkStealingScheduler &scheduler)  {
+    if (root_sequence.size() != roots.size())
+        sequence_roots();
+    batch_root_searches();
+    vector<double> costs = root_costs();
+
+    hashes.resize(roots.size());
+    root_threads = split_heavy_roots(costs);
+    for (unsigned k=0; k<roots.size(); k++)  {
+        unsigned i = root_sequence[k];
+        if (root_threads[i] > 1)  {
+            hashes[i] = get_graphlets_counts(graph, roots[i], root_threads[i]);
+            costs[i] = 0.0;
+        }
+    }
+
+    run_sequenced(scheduler, costs, [&](unsigned k)  {
+        unsigned i = root_sequence[k];
+        if (root_threads[i] <= 1)
+            hashes[i] = get_graphlets_counts(graph, roots[i]);
+    });
+}
+
+// Searches around consecutive roots share most of their vertices when nearly
+// every vertex is a root (e.g. all atoms of a protein), so they are run
+// BFS_BATCH at a time, in the order of root_sequence. For scattered roots a batch costs as much as separate
+// searches, and get_graphlets_counts searches around each root on its own.
+void GraphKernel::batch_root_searches()  {
+    if (!root_batches.empty() || 2 * roots.size() < graph.adj.size())
+        return;
+
+    vector<unsigned> sources(roots.size());
+    for (unsigned k=0; k<roots.size(); k++)
+        sources[k] = roots[root_sequence[k]];
+
+    unsigned batches = (roots.size() + BFS_BATCH - 1) / BFS_BATCH;
+    root_batches.resize(batches);
+    WorkStealingScheduler scheduler(THREADS);
+    scheduler.run(vector<double>(batches, 1.0), [&](unsigned b)  {
+        static thread_local BfsBuffers scratch;
+        unsigned first = b * BFS_BATCH;
+        graph.multi_source_bfs(&sources[first], min<unsigned>(BFS_BATCH, sources.size() - first), GRAPHLET_DEPTH, root_batches[b], scratch);
+    });
+
+    root_batch_slot.assign(graph.adj.size(), UINT_MAX);
+    for (unsigned k=0; k<sources.size(); k++)  {
+        if (root_batch_slot[sources[k]] == UINT_MAX)
+            root_batch_slot[sources[k]] = k;
+    }
+}
+
+// Number of threads used to count graphlets around each root. A root whose cost
+// exceeds the fair share of a worker would leave the other workers idle at the end,
+// so its enumeration is split across all threads.
+vector<unsigned> GraphKernel::split_heavy_roots(const vector<double> &costs)  {
+    unsigned threads = resolve_threads(THREADS);
+    vector<unsigned> split(costs.size(), 1);
+    double total(0.0);
+
+    for (unsigned i=0; i<costs.size(); i++)
+        total += costs[i];
+
+    if (threads > 1)  {
+        for (unsigned i=0; i<costs.size(); i++)  {
+            if (costs[i] * threads > total)
+                split[i] = threads;
+        }
+    }
+    return split;
+}
+
+// Estimated cost of counting graphlets around each root. Enumeration is dominated
+// by the triples (4-graphlets) or quadruples (5-graphlets) of neighbors of the root
+// and by the paths leaving it through each neighbor.
+vector<double> GraphKernel::root_costs()  {
+    vector<double> costs(roots.size());
+    for (unsigned i=0; i<roots.size(); i++)  {
+        double deg = graph.adj[roots[i]].size();
+        double paths = 0.0;
+        for (unsigned j=0; j<graph.adj[roots[i]].size(); j++)
+            paths += graph.adj[graph.adj[roots[i]][j]].size();
+
+        costs[i] = 1.0 + deg * deg * deg + deg * paths;
+        #if GRAPHLETS_5
+        costs[i] += deg * deg * deg * deg + deg * deg * paths;
+        #endif
+    }
+    return costs;
+}
+
+// Estimated cost of computing the i-th row of the lower triangular kernel matrix.
+vector<double> GraphKernel::row_costs()  {
+    vector<double> costs(roots.size());
+    for (unsigned i=0; i<roots.size(); i++)
+        costs[i] = i + 1.0;
+    return costs;
+}
+
 #if OUTPUT_FORMAT == 0
 void GraphKernel::write_matrix(const char *file)  {
     ofstream out(file, ios::out | ios::binary);
@@ -334,136 +720,311 @@ void GraphKernel::write_sparse_svml_lm(const char *file)  {
             cerr << "Computing attributes for Standard Graphlet Kernel ... ";
     }
 
-	ofstream out(file, ios::out);	
-    for (unsigned i=0; i<roots.size(); i++)  {
-        if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
+    write_features(file, &GraphKernel::sparse_features_lm);
+}
 
-        out << labels[i];
+void GraphKernel::write_sparse_svml_em(const char *file)  {
+    if (VERBOSE)  cerr << "Computing attributes for Edge Indels Graphlet Kernel ... ";
 
-        vector<map<Key,MismatchInfo> > g_hash = get_graphlets_counts(graph, roots[i]);
-        for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
-			if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
-                int VLM= set_k(g_type, SF);
-                map<Key,MismatchInfo> mismatch_hash;
+    write_features(file, &GraphKernel::sparse_features_em);
+}
+
+void GraphKernel::write_sparse_svml_ed(const char *file)  {
+    if (VERBOSE)  cerr << "Computing attributes for Edit Distance Graphlet Kernel (d=1) ... ";
 
-                add_vertex_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, VLM, false);
+    write_features(file, &GraphKernel::sparse_features_ed);
+}
 
-                update_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, false, VLM, false);                                
-				for (map<Key,MismatchInfo>::iterator it = g_hash[g_type].begin(); it != g_hash[g_type].end(); it++)  {
-                    out << " " << get_feature_id(it->first, g_type) << ":" << retrieve_label_mismatch_count(g_type, g_hash[g_type], it->first);
-                }
-			}
-			vl_mismatch_neighborhood.clear();
+void GraphKernel::write_sparse_svml_ed2(const char *file)  {
+    if (VERBOSE)  cerr << "Computing attributes for Edit Distance Graphlet Kernel (d=2) ... ";
+
+    write_features(file, &GraphKernel::sparse_features_ed2);
+}
+
+void GraphKernel::write_features(const char *file, FeatureVector (GraphKernel::*features)(unsigned))  {
+    if (model != NULL)
+        write_posteriors(file, features);
+    else if (SPARSE_CSR)
+        write_sparse_csr(file, features);
+    else
+        write_sparse_svml(file, features);
+}
+
+// Roots are counted concurrently, heaviest first, but lines are written in root order.
+// Heavy roots are counted one at a time beforehand, each split across all threads.
+// Roots processed out of input order (ROOT_ORDER) or numbered by a vocabulary have
+// all their features kept until every root is done, then written in input order.
+void GraphKernel::write_sparse_svml(const char *file, FeatureVector (GraphKernel::*features)(unsigned))  {
+	ofstream out(file, ios::out);
+
+    if (ROOT_ORDER != ROOTS_INPUT || vocabulary != NULL)  {
+        vector<FeatureVector> rows = all_root_features(features);
+        if (vocabulary != NULL)
+            map_feature_columns(rows);
+        for (unsigned i=0; i<roots.size(); i++)  {
+            if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
+            out << svml_line(i, rows[i]) << endl;
         }
-        out << " #" << i << endl;
+        out.close();
+
+        if (VERBOSE)  cerr << endl;
+        return;
     }
+
+    if (root_sequence.size() != roots.size())
+        sequence_roots();
+    batch_root_searches();
+    vector<double> costs = root_costs();
+    vector<string> lines(roots.size());
+
+    root_threads = split_heavy_roots(costs);
+    for (unsigned i=0; i<roots.size(); i++)  {
+        if (root_threads[i] > 1)  {
+            lines[i] = svml_line(i, (this->*features)(i));
+            costs[i] = 0.0;
+        }
+    }
+
+    ordered_parallel_for(costs, THREADS,
+        [&](unsigned i)  { return root_threads[i] > 1 ? lines[i] : svml_line(i, (this->*features)(i)); },
+        [&](unsigned i, const string &line)  {
+            if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
+            out << line << endl;
+            lines[i].clear();
+        });
     out.close();
 
     if (VERBOSE)  cerr << endl;
 }
 
-void GraphKernel::write_sparse_svml_em(const char *file)  {
-    if (VERBOSE)  cerr << "Computing attributes for Edge Indels Graphlet Kernel ... ";
+// Row i of the arrays is the i-th root, as the i-th SVML line; indices are the
+// feature ids (or vocabulary columns) of the SVML lines.
+void GraphKernel::write_sparse_csr(const char *prefix, FeatureVector (GraphKernel::*features)(unsigned))  {
+    vector<FeatureVector> rows = all_root_features(features);
+    if (vocabulary != NULL)
+        map_feature_columns(rows);
+
+    vector<int64_t> indptr(1, 0), indices;
+    vector<float> data;
+    for (unsigned i=0; i<rows.size(); i++)  {
+        for (unsigned t=0; t<rows[i].size(); t++)  {
+            indices.push_back(rows[i][t].first);
+            data.push_back(rows[i][t].second);
+        }
+        indptr.push_back(indices.size());
+        FeatureVector().swap(rows[i]);
+    }
 
-	ofstream out(file, ios::out);
-    for (unsigned i=0; i<roots.size(); i++)  {
-        if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
+    vector<int32_t> row_labels(labels.begin(), labels.end());
+    vector<uint32_t> row_roots(input_roots.empty() ? roots : input_roots);
+    row_labels.resize(roots.size(), 0);
 
-        out << labels[i];
+    string file(prefix);
+    write_npy(file + ".indptr.npy", indptr);
+    write_npy(file + ".indices.npy", indices);
+    write_npy(file + ".data.npy", data);
+    write_npy(file + ".labels.npy", row_labels);
+    write_npy(file + ".roots.npy", row_roots);
 
-        vector<map<Key,MismatchInfo> > g_hash = get_graphlets_counts(graph, roots[i]);
-        add_edge_mismatch_counts(g_hash);        
-        for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
-            if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
-                for (map<Key,MismatchInfo>::iterator it = g_hash[g_type].begin(); it != g_hash[g_type].end(); it++)  {
-                    out << " " << get_feature_id(it->first, g_type) << ":" << retrieve_edge_mismatch_count(g_hash[g_type], it->first);
-                }
-            }
+    if (VERBOSE)  cerr << roots.size() << " rows, " << indices.size() << " entries" << endl;
+}
+
+// Each root is scored as soon as its features are counted, so only one vector of
+// counts per thread is alive at a time.
+void GraphKernel::score_roots(FeatureVector (GraphKernel::*features)(unsigned))  {
+    posteriors.assign(roots.size(), 0.0);
+    for_each_root_features(features, [&](unsigned i, FeatureVector &row)  {
+        posteriors[i] = model->posterior(row);
+    });
+}
+
+const vector<double> &GraphKernel::score_roots_lm()  {
+    score_roots(&GraphKernel::sparse_features_lm);
+    return posteriors;
+}
+
+void GraphKernel::write_posteriors(const char *file, FeatureVector (GraphKernel::*features)(unsigned))  {
+    score_roots(features);
+    write_npy(file, posteriors);
+
+    if (VERBOSE)  cerr << roots.size() << " posteriors" << endl;
+}
+
+void GraphKernel::write_residue_posteriors(const char *file, unsigned reduce)  {
+    const vector<unsigned> &vertices = input_roots.empty() ? roots : input_roots;
+    vector<unsigned> root_residues(vertices.size());
+    for (unsigned i=0; i<vertices.size(); i++)  {
+        if (vertices[i] >= residues.size())  {
+            cerr << "ERROR: Vertex of interest " << vertices[i] << " has no residue index (" << residues.size() << " given)." << endl; exit(1);
         }
-        out << " #" << i << endl;
+        root_residues[i] = residues[vertices[i]];
     }
-    out.close();
 
-    if (VERBOSE)  cerr << endl;
+    vector<double> reduced = residue_posteriors(posteriors, root_residues, reduce);
+    write_npy(file, reduced);
+
+    if (VERBOSE)  cerr << reduced.size() << " residue posteriors" << endl;
 }
 
-void GraphKernel::write_sparse_svml_ed(const char *file)  {
-    if (VERBOSE)  cerr << "Computing attributes for Edit Distance Graphlet Kernel (d=1) ... ";
+vector<FeatureVector> GraphKernel::all_root_features(FeatureVector (GraphKernel::*features)(unsigned))  {
+    vector<FeatureVector> rows(roots.size());
+    for_each_root_features(features, [&](unsigned i, FeatureVector &row)  { rows[i].swap(row); });
+    return rows;
+}
 
-    ofstream out(file, ios::out);
-    for (unsigned i=0; i<roots.size(); i++)  {
-        if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
+void GraphKernel::for_each_root_features(FeatureVector (GraphKernel::*features)(unsigned), const function<void(unsigned, FeatureVector&)> &use)  {
+    if (root_sequence.size() != roots.size())
+        sequence_roots();
+    batch_root_searches();
+    vector<double> costs = root_costs();
+
+    root_threads = split_heavy_roots(costs);
+    for (unsigned k=0; k<roots.size(); k++)  {
+        unsigned i = root_sequence[k];
+        if (root_threads[i] > 1)  {
+            FeatureVector row = (this->*features)(i);
+            use(i, row);
+            costs[i] = 0.0;
+        }
+    }
 
-        out << labels[i];
+    WorkStealingScheduler scheduler(THREADS);
+    run_sequenced(scheduler, costs, [&](unsigned k)  {
+        unsigned i = root_sequence[k];
+        if (root_threads[i] <= 1)  {
+            FeatureVector row = (this->*features)(i);
+            use(i, row);
+        }
+    });
+}
 
-        vector<map<Key,MismatchInfo> > g_hash = get_graphlets_counts(graph, roots[i]);
-        add_edge_mismatch_counts(g_hash);
-        for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {            
-            if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
-                int VLM = set_k(g_type, SF);
-                map<Key,MismatchInfo> mismatch_hash;
-                if(VLM >= 1)                    
-                    add_vertex_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, 1, false);
-                    
-                update_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, false, 1, true);
-                
-                for (map<Key,MismatchInfo>::iterator it = g_hash[g_type].begin(); it != g_hash[g_type].end(); it++)  {                    
-                    if (retrieve_label_mismatch_count(g_type, g_hash[g_type], it->first) > 0.0)  {
-                        out << " " << get_feature_id(it->first, g_type) << ":" << retrieve_label_mismatch_count(g_type, g_hash[g_type], it->first);
-                    }
-                }
+// New features are numbered in root order, then in the order of each row, so
+// the columns do not depend on the number of threads or the root order.
+void GraphKernel::map_feature_columns(vector<FeatureVector> &rows)  {
+    size_t dropped = 0;
+    for (unsigned i=0; i<rows.size(); i++)  {
+        unsigned kept = 0;
+        for (unsigned t=0; t<rows[i].size(); t++)  {
+            unsigned column = vocabulary->column(rows[i][t].first);
+            if (column == NO_COLUMN)
+                dropped++;
+            else
+                rows[i][kept++] = make_pair((Key) column, rows[i][t].second);
+        }
+        rows[i].resize(kept);
+        sort(rows[i].begin(), rows[i].end());
+    }
+
+    if (VERBOSE && dropped > 0)  cerr << dropped << " counts of features outside the vocabulary dropped ... ";
+}
+
+string GraphKernel::svml_line(unsigned i, const FeatureVector &features)  {
+    ostringstream out;
+
+    out << labels[i];
+    for (unsigned t=0; t<features.size(); t++)
+        out << " " << features[t].first << ":" << features[t].second;
+    out << " #" << i;
+
+    return out.str();
+}
+
+FeatureVector GraphKernel::sparse_features_lm(unsigned i)  {
+    FeatureVector features;
+    map<Key, list<Key> > vl_mismatch_neighborhood;
+
+    vector<MismatchHash> g_hash = get_graphlets_counts(graph, roots[i], root_threads[i]);
+    for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
+        if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
+            int VLM= set_k(g_type, SF);
+            MismatchHash mismatch_hash;
+
+            add_vertex_label_mismatch_counts(g_hash[g_type], mismatch_hash, vl_mismatch_neighborhood, g_type, VLM, false);
+
+            update_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, false, VLM, false);                                
+            for (MismatchHash::iterator it = g_hash[g_type].begin(); it != g_hash[g_type].end(); it++)  {
+                features.push_back(make_pair(get_feature_id(it->first, g_type), retrieve_label_mismatch_count(g_type, g_hash[g_type], it->first)));
             }
-			vl_mismatch_neighborhood.clear();
-        }       
-        out << " #" << i << endl;
+        }
+        vl_mismatch_neighborhood.clear();
     }
-    out.close();
+    return features;
+}
 
-    if (VERBOSE)  cerr << endl;
+FeatureVector GraphKernel::sparse_features_em(unsigned i)  {
+    FeatureVector features;
+
+    vector<MismatchHash> g_hash = get_graphlets_counts(graph, roots[i], root_threads[i]);
+    add_edge_mismatch_counts(g_hash);        
+    for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
+        if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
+            for (MismatchHash::iterator it = g_hash[g_type].begin(); it != g_hash[g_type].end(); it++)  {
+                features.push_back(make_pair(get_feature_id(it->first, g_type), retrieve_edge_mismatch_count(g_hash[g_type], it->first)));
+            }
+        }
+    }
+    return features;
 }
 
-void GraphKernel::write_sparse_svml_ed2(const char *file)  {
-    if (VERBOSE)  cerr << "Computing attributes for Edit Distance Graphlet Kernel (d=2) ... ";
+FeatureVector GraphKernel::sparse_features_ed(unsigned i)  {
+    FeatureVector features;
+    map<Key, list<Key> > vl_mismatch_neighborhood;
 
-    ofstream out(file, ios::out);
-    for (unsigned i=0; i<roots.size(); i++)  {
-        if (VERBOSE && (i+1) % 100 == 0)  cerr << " " << i+1;
+    vector<MismatchHash> g_hash = get_graphlets_counts(graph, roots[i], root_threads[i]);
+    add_edge_mismatch_counts(g_hash);
+    for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {            
+        if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
+            int VLM = set_k(g_type, SF);
+            MismatchHash mismatch_hash;
+            if(VLM >= 1)                    
+                add_vertex_label_mismatch_counts(g_hash[g_type], mismatch_hash, vl_mismatch_neighborhood, g_type, 1, false);
+                
+            update_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, false, 1, true);
+            
+            for (MismatchHash::iterator it = g_hash[g_type].begin(); it != g_hash[g_type].end(); it++)  {                    
+                if (retrieve_label_mismatch_count(g_type, g_hash[g_type], it->first) > 0.0)  {
+                    features.push_back(make_pair(get_feature_id(it->first, g_type), retrieve_label_mismatch_count(g_type, g_hash[g_type], it->first)));
+                }
+            }
+        }
+        vl_mismatch_neighborhood.clear();
+    }       
+    return features;
+}
 
-        out << labels[i];
+FeatureVector GraphKernel::sparse_features_ed2(unsigned i)  {
+    FeatureVector features;
+    map<Key, list<Key> > vl_mismatch_neighborhood;
 
-        vector<map<Key,MismatchInfo> > g_hash = get_graphlets_counts(graph, roots[i]);
-        add_1_edge_mismatch_counts(g_hash);
-        for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {            
-            if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
-                int VLM = set_k(g_type, SF);
-                map<Key,MismatchInfo> mismatch_hash;
+    vector<MismatchHash> g_hash = get_graphlets_counts(graph, roots[i], root_threads[i]);
+    add_1_edge_mismatch_counts(g_hash);
+    for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {            
+        if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
+            int VLM = set_k(g_type, SF);
+            MismatchHash mismatch_hash;
 
-                if(VLM >= 1)                    
-                    add_vertex_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, 1, true);
-                                    
-                update_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, true, 1, true);
-                vl_mismatch_neighborhood.clear();
+            if(VLM >= 1)                    
+                add_vertex_label_mismatch_counts(g_hash[g_type], mismatch_hash, vl_mismatch_neighborhood, g_type, 1, true);
+                                
+            update_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, true, 1, true);
+            vl_mismatch_neighborhood.clear();
 
-                add_2_edge_mismatch_counts(g_hash);
+            add_2_edge_mismatch_counts(g_hash);
 
-                if (VLM >= 2)
-                    add_vertex_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, 2, false);
+            if (VLM >= 2)
+                add_vertex_label_mismatch_counts(g_hash[g_type], mismatch_hash, vl_mismatch_neighborhood, g_type, 2, false);
 
-                update_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, false, 2, true);
-                vl_mismatch_neighborhood.clear();
+            update_label_mismatch_counts(g_hash[g_type], mismatch_hash, g_type, false, 2, true);
+            vl_mismatch_neighborhood.clear();
 
-                for (map<Key,MismatchInfo>::iterator it = g_hash[g_type].begin(); it != g_hash[g_type].end(); it++)  {                    
-                    if (retrieve_label_mismatch_count(g_type, g_hash[g_type], it->first) > 0.0)  {
-                        out << " " << get_feature_id(it->first, g_type) << ":" << retrieve_label_mismatch_count(g_type, g_hash[g_type], it->first);
-                    }
+            for (MismatchHash::iterator it = g_hash[g_type].begin(); it != g_hash[g_type].end(); it++)  {                    
+                if (retrieve_label_mismatch_count(g_type, g_hash[g_type], it->first) > 0.0)  {
+                    features.push_back(make_pair(get_feature_id(it->first, g_type), retrieve_label_mismatch_count(g_type, g_hash[g_type], it->first)));
                 }
             }
         }
-        out << " #" << i << endl;
     }
-    out.close();
-
-    if (VERBOSE)  cerr << endl;
+    return features;
 }
 
 void GraphKernel::write_labels(const char *file)  {
@@ -575,34 +1136,141 @@ float GraphKernel::random_walk(SimpleGraph &g, unsigned g1_root, unsigned g2_roo
     return value;
 }
 
+// Sizes the tables of a root so they do not rehash while counting. A root of
+// degree d with p paths of length 2 has at most d distinct 2-graphlets, at
+// most d(d-1)/2 + p 3-graphlets, and at most d times as many 4-graphlets;
+// distinct keys are also bounded by the labels, hence MAX_TABLE_RESERVE.
+static void reserve_tables(vector<MismatchHash> &hash, const SimpleGraph &local)  {
+    size_t d = local.adj[0].size(), p = 0;
+    for (unsigned t=0; t<d; t++)
+        p += local.adj[local.adj[0][t]].size() - 1;
+    size_t three = min<size_t>(d * (d - (d > 0)) / 2 + p, MAX_TABLE_RESERVE);
+    size_t four = min<size_t>(d * three, MAX_TABLE_RESERVE);
+
+    hash[1].reserve(d);
+    for (unsigned g_type=2; g_type<=4; g_type++)
+        hash[g_type].reserve(three);
+    #if GRAPHLETS_4
+    for (unsigned g_type=5; g_type<=15; g_type++)
+        hash[g_type].reserve(four);
+    #endif
+}
+
 // Count graphlets starting from root.
-vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g, unsigned g_root)  {
-    map<Key,MismatchInfo> T;
-    vector<map<Key,MismatchInfo> > hash(GRAPHLET_TYPES, T);
-    vector<unsigned> dist = g.breadth_first_sort(g_root);
-	vector<Key> mismatches;
+vector<MismatchHash> GraphKernel::get_graphlets_counts(SimpleGraph &g, unsigned g_root, unsigned threads)  {
+    MismatchHash T;
+    vector<MismatchHash> hash(GRAPHLET_TYPES, T);
 	Key key;
 
-	unsigned i, j, k, l;
-    char root, a, b, c, d;
+    char root;
     
     root = g.nodes[g_root];
 
 	// 1-graphlets, case 0
     #if GRAPHLETS_1	
-	key = create_permutations_subset(mismatches, root, ZERO_CHAR, ZERO_CHAR, ZERO_CHAR, ZERO_CHAR, 0);	
-	increment_match_hash(hash[0], key, mismatches);
+	key = canonical_key(root, ZERO_CHAR, ZERO_CHAR, ZERO_CHAR, ZERO_CHAR, 0);	
+	increment_match_hash(hash[0], key);
 
     #endif
 
-    for (unsigned i_=0; i_<g.adj[g_root].size(); i_++)  {
+    // Enumerate on a compact copy of the neighborhood, with local ids in the order
+    // of the search: BFS order from bounded_bfs, discovery order of the batch from
+    // MultiSourceBfs::get (not sorted by distance). Enumeration only reads the
+    // distances and keeps the order of the adjacency lists, so either gives the
+    // same counts. Small neighborhoods get an adjacency bit matrix that stays in L1,
+    // larger ones only if they are dense enough to pay for it (see index_edges).
+    // Scratch space is per thread and reused across roots.
+    static thread_local BfsBuffers bfs_buffers;
+    static thread_local SimpleGraph local_graph;
+    unsigned slot = (&g == &graph && g_root < root_batch_slot.size()) ? root_batch_slot[g_root] : UINT_MAX;
+    if (slot != UINT_MAX)  {
+        root_batches[slot / BFS_BATCH].get(slot % BFS_BATCH, bfs_buffers);
+        g.extract_neighborhood(GRAPHLET_DEPTH, bfs_buffers, local_graph);
+    }
+    else
+        g.extract_neighborhood(g_root, GRAPHLET_DEPTH, bfs_buffers, local_graph);
+
+    // Named references, as lambdas run on other threads would see their own thread_locals.
+    SimpleGraph &local = local_graph;
+    const vector<unsigned> &dist = bfs_buffers.level;
+
+    unsigned parts = min<unsigned>(resolve_threads(threads), g.adj[g_root].size());
+    if (parts <= 1)  {
+        reserve_tables(hash, local);
+        count_graphlets_from(local, 0, dist, 0, 1, hash);
+    }
+    else  {
+        // Split the neighbors of the root across threads. Iteration i_ of the outer loop
+        // gets more expensive with i_, so neighbors are dealt in a strided fashion.
+        vector<vector<MismatchHash> > partial(parts, vector<MismatchHash>(GRAPHLET_TYPES, T));
+        WorkStealingScheduler scheduler(parts);
+        scheduler.run(vector<double>(parts, 1.0), [&](unsigned p)  {
+            count_graphlets_from(local, 0, dist, p, parts, partial[p]);
+        });
+
+        // Merge thread-local counts. Permutation subsets only depend on the key,
+        // so they are copied over when a key is first seen.
+        for (unsigned p=0; p<parts; p++)  {
+            for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
+                for (MismatchHash::iterator it = partial[p][g_type].begin(); it != partial[p][g_type].end(); it++)  {
+                    MismatchHash::iterator hit = hash[g_type].find(it->first);
+                    if (hit == hash[g_type].end())
+                        hash[g_type][it->first] = it->second;
+                    else
+                        hit->second.matches = hit->second.matches + it->second.matches;
+                }
+            }
+            partial[p].clear();
+        }
+    }
+
+    // Keep the std::map iteration order, which fixes the order of the SVML
+    // features and of floating point sums downstream.
+    for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)
+        hash[g_type].sort_by_key();
+    
+    if (NORMALIZE)
+        normalize_spectral(hash);
+
+    return hash;
+}
+
+// Count graphlets starting from root that go through the neighbors
+// g.adj[g_root][first], g.adj[g_root][first+stride], ... of the root.
+void GraphKernel::count_graphlets_from(SimpleGraph &g, unsigned g_root, const vector<unsigned> &dist, unsigned first, unsigned stride, vector<MismatchHash> &hash)  {
+	unsigned i, j, k, l;
+    char root, a, b, c, d;
+    
+    root = g.nodes[g_root];
+
+    // Occurrences are canonicalized in batches per orbit.
+    GraphletBuffer graphlets(root, hash);
+
+    // With a bit matrix (always the case for small neighborhoods), cases 011
+    // and 0112 are counted per label; see LabelRows.
+    static thread_local LabelRows label_rows;
+    bool by_label = g.has_bit_matrix();
+    unsigned n_passed = 0;
+    if (by_label)
+        label_rows.build(g, dist);
+
+    for (unsigned i_=first; i_<g.adj[g_root].size(); i_+=stride)  {
         i = g.adj[g_root][i_];
         a = g.nodes[i];
 
         // 2-graphlets, case 01
 		#if GRAPHLETS_2
-		key = create_permutations_subset(mismatches, root, a, ZERO_CHAR, ZERO_CHAR, ZERO_CHAR, 1);	
-		increment_match_hash(hash[1], key, mismatches);        
+		graphlets.add(1, a, ZERO_CHAR, ZERO_CHAR, ZERO_CHAR);        
+		#endif
+
+		#if GRAPHLETS_3
+		if (by_label)  {
+			// 3-graphlets, case 011: the root neighbors j_ < i_ of every label,
+			// adjacent to i or not.
+			for (; n_passed < i_; n_passed++)
+				label_rows.pass(g, g.adj[g_root][n_passed]);
+			label_rows.add_triangles(graphlets, g, i);
+		}
 		#endif
 		
         for (unsigned j_=0; j_<i_; j_++)  {
@@ -611,19 +1279,15 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
             b = g.nodes[j];
 
 			#if GRAPHLETS_3
-            bool found(false);
-            unsigned t(0);
-            while (!found && t<g.adj[i].size())  {
-                found = (j == g.adj[i][t++]);
-            }
-            if (found)  {
-				key = create_permutations_subset(mismatches, root, a, b, ZERO_CHAR, ZERO_CHAR, 4);
-				increment_match_hash(hash[4], key, mismatches);                
-            } 
-            else  {
-				key = create_permutations_subset(mismatches, root, a, b, ZERO_CHAR, ZERO_CHAR, 3);
-				increment_match_hash(hash[3], key, mismatches);                
-            }
+			if (!by_label)  {
+				bool found = g.has_edge(i, j);
+				if (found)  {
+					graphlets.add(4, a, b, ZERO_CHAR, ZERO_CHAR);                
+				} 
+				else  {
+					graphlets.add(3, a, b, ZERO_CHAR, ZERO_CHAR);                
+				}
+			}
 			#endif
 
             // 4-graphlets, case 0111
@@ -632,56 +1296,39 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
                 c = g.nodes[k];
 				
 				#if GRAPHLETS_4
-                bool found_ij(false), found_ik(false), found_jk(false);
-                unsigned t(0);
-                while(!found_ij && t<g.adj[i].size())
-                    found_ij = (j == g.adj[i][t++]);
-
-                t = 0;
-                while (!found_ik && t<g.adj[i].size())
-                    found_ik = (k == g.adj[i][t++]);
-
-                t = 0;
-                while (!found_jk && t<g.adj[j].size())
-                    found_jk = (k == g.adj[j][t++]);
+                bool found_ij = g.has_edge(i, j);
+                bool found_ik = g.has_edge(i, k);
+                bool found_jk = g.has_edge(j, k);
 
                 if (found_ij)  {
                     if (found_ik)  {
                         if (found_jk)  {
-							key = create_permutations_subset(mismatches, root, a, b, c, ZERO_CHAR, 15);
-							increment_match_hash(hash[15], key, mismatches);                            
+							graphlets.add(15, a, b, c, ZERO_CHAR);                            
                         } else  {
-							key = create_permutations_subset(mismatches, root, b, c, a, ZERO_CHAR, 14);
-							increment_match_hash(hash[14], key, mismatches);
+							graphlets.add(14, b, c, a, ZERO_CHAR);
                         }
                     }
                     else  {
                         if (found_jk)  {
-							key = create_permutations_subset(mismatches, root, a, c, b, ZERO_CHAR, 14);
-							increment_match_hash(hash[14], key, mismatches);
+							graphlets.add(14, a, c, b, ZERO_CHAR);
                         } else  {
-							key = create_permutations_subset(mismatches, root, c, a, b, ZERO_CHAR, 10);
-							increment_match_hash(hash[10], key, mismatches);
+							graphlets.add(10, c, a, b, ZERO_CHAR);
                         }
                     }
                 }
                 else  {
                     if (found_ik)  {
                         if (found_jk)  {
-							key = create_permutations_subset(mismatches, root, a, b, c, ZERO_CHAR, 14);
-							increment_match_hash(hash[14], key, mismatches);
+							graphlets.add(14, a, b, c, ZERO_CHAR);
                         } else  {
-							key = create_permutations_subset(mismatches, root, b, a, c, ZERO_CHAR, 10);
-							increment_match_hash(hash[10], key, mismatches);                            
+							graphlets.add(10, b, a, c, ZERO_CHAR);                            
                         }
                     }
                     else  {
                         if (found_jk)  {
-							key = create_permutations_subset(mismatches, root, a, b, c, ZERO_CHAR, 10);
-							increment_match_hash(hash[10], key, mismatches);
+							graphlets.add(10, a, b, c, ZERO_CHAR);
                         } else  {
-							key = create_permutations_subset(mismatches, root, a, b, c, ZERO_CHAR, 8);
-							increment_match_hash(hash[8], key, mismatches);
+							graphlets.add(8, a, b, c, ZERO_CHAR);
                         }
                     }
                 }
@@ -693,32 +1340,12 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 					d = g.nodes[l];                    
 					
 					#if GRAPHLETS_5
-                    bool found_ij(false), found_ik(false), found_il(false), found_jk(false), found_jl(false), found_kl(false);
-					unsigned t(0);
-					while(!found_ij && t<g.adj[i].size())  {
-						found_ij = (j == g.adj[i][t++]);
-                    }
-					
-					t = 0;
-					while (!found_ik && t<g.adj[i].size())
-						found_ik = (k == g.adj[i][t++]);
-					
-					t = 0;
-					while(!found_il && t<g.adj[i].size())
-						found_il = (l == g.adj[i][t++]);
-					
-					t = 0;
-					while (!found_jk && t<g.adj[j].size())
-						found_jk = (k == g.adj[j][t++]);
-					
-					t = 0;
-					while (!found_jl && t<g.adj[j].size())
-						found_jl = (l == g.adj[j][t++]);
-					
-					t = 0;
-					while (!found_kl && t<g.adj[k].size())  {
-						found_kl = (l == g.adj[k][t++]);
-                    }
+                    bool found_ij = g.has_edge(i, j);
+                    bool found_ik = g.has_edge(i, k);
+                    bool found_il = g.has_edge(i, l);
+                    bool found_jk = g.has_edge(j, k);
+                    bool found_jl = g.has_edge(j, l);
+                    bool found_kl = g.has_edge(k, l);
 
 					if (found_ij)  {
 						if (found_ik)  {
@@ -726,44 +1353,36 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jk)  {
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, b, c, d, 26);
-											increment_match_hash(hash[26], key, mismatches);
+											graphlets.add(26, a, b, c, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, a, b, c, d, 25);
-											increment_match_hash(hash[25], key, mismatches);
+											graphlets.add(25, a, b, c, d);
 										}
 									}
 									else  {                                            
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, c, b, d, 25);
-											increment_match_hash(hash[25], key, mismatches);
+											graphlets.add(25, a, c, b, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, d, b, c, a, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, d, b, c, a);
 										}
 									}
 								}
 								else  {                                    
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, d, b, c, 25);
-											increment_match_hash(hash[25], key, mismatches);
+											graphlets.add(25, a, d, b, c);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, c, b, d, a, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, c, b, d, a);
 										}
 									}
 									else  {                                            
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, b, c, d, a, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, b, c, d, a);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, b, c, d, a, 22);
-											increment_match_hash(hash[22], key, mismatches);
+											graphlets.add(22, b, c, d, a);
 										}
 									}
 								}
@@ -772,44 +1391,36 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jk)  {
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, b, c, a, d, 25);
-											increment_match_hash(hash[25], key, mismatches);
+											graphlets.add(25, b, c, a, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, d, a, c, b, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, d, a, c, b);
 										}
 									}
 									else  {                                            
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, d, a, b, c, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, d, a, b, c);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, d, a, b, c, 21);
-											increment_match_hash(hash[21], key, mismatches);
+											graphlets.add(21, d, a, b, c);
 										}
 									}
 								}
 								else  {                                    
 									if (found_jl)  {
 										if (found_kl)  {                                            
-                                            key = create_permutations_subset(mismatches, root, a, d, b, c, 23);
-											increment_match_hash(hash[23], key, mismatches);
+                                            graphlets.add(23, a, d, b, c);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, a, b, c, d, 20);
-											increment_match_hash(hash[20], key, mismatches);
+											graphlets.add(20, a, b, c, d);
 										}
 									}
 									else  {                                            
 										if (found_kl)  {
-                                            key = create_permutations_subset(mismatches, root, a, c, b, d, 20);
-											increment_match_hash(hash[20], key, mismatches);
+                                            graphlets.add(20, a, c, b, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, d, b, c, a, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, d, b, c, a);
 										}
 									}
 								}
@@ -820,44 +1431,36 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jk)  {
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, b, d, a, c, 25);
-											increment_match_hash(hash[25], key, mismatches);
+											graphlets.add(25, b, d, a, c);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, c, a, d, b, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, c, a, d, b);
 										}
 									}
 									else  {
 										if (found_kl)  {
-                                            key = create_permutations_subset(mismatches, root, a, c, b, d, 23);
-											increment_match_hash(hash[23], key, mismatches);											
+                                            graphlets.add(23, a, c, b, d);											
 										}
 										else  {
-                                            key = create_permutations_subset(mismatches, root, a, b, d, c, 20);
-											increment_match_hash(hash[20], key, mismatches);
+                                            graphlets.add(20, a, b, d, c);
 										}
 									}
 								}
 								else  {                                    
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, c, a, b, d, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, c, a, b, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, c, a, b, d, 21);
-											increment_match_hash(hash[21], key, mismatches);
+											graphlets.add(21, c, a, b, d);
 										}
 									}
 									else  {
 										if (found_kl)  {
-                                            key = create_permutations_subset(mismatches, root, a, d, b, c, 20);
-											increment_match_hash(hash[20], key, mismatches);
+                                            graphlets.add(20, a, d, b, c);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, c, b, d, a, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, c, b, d, a);
 										}
 									}
 								}
@@ -866,44 +1469,36 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jk)  {
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, c, d, b, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, a, c, d, b);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, a, c, d, b, 22);
-											increment_match_hash(hash[22], key, mismatches);
+											graphlets.add(22, a, c, d, b);
 										}
 									}
 									else  {                                            
 										if (found_kl)  {
-                                            key = create_permutations_subset(mismatches, root, b, c, a, d, 20);
-											increment_match_hash(hash[20], key, mismatches);
+                                            graphlets.add(20, b, c, a, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, d, a, c, b, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, d, a, c, b);
 										}
 									}
 								}
 								else  {                                    
 									if (found_jl)  {
 										if (found_kl)  {
-                                            key = create_permutations_subset(mismatches, root, b, d, a, c, 20);
-											increment_match_hash(hash[20], key, mismatches);
+                                            graphlets.add(20, b, d, a, c);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, c, a, d, b, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, c, a, d, b);
 										}
 									}
 									else  { 
 										if (found_kl)  {
-                                            key = create_permutations_subset(mismatches, root, a, b, c, d, 18);
-											increment_match_hash(hash[18], key, mismatches);											
+                                            graphlets.add(18, a, b, c, d);											
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, c, d, a, b, 17);
-											increment_match_hash(hash[17], key, mismatches);
+											graphlets.add(17, c, d, a, b);
 										}
 									}
 								}
@@ -916,44 +1511,36 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jk)  {
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, c, d, a, b, 25);
-											increment_match_hash(hash[25], key, mismatches);
+											graphlets.add(25, c, d, a, b);
 										}
 										else  {
-                                            key = create_permutations_subset(mismatches, root, a, b, c, d, 23);
-											increment_match_hash(hash[23], key, mismatches);											
+                                            graphlets.add(23, a, b, c, d);											
 										}
 									}
 									else  {                                            
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, b, a, d, c, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, b, a, d, c);
 										}
 										else  {
-                                            key = create_permutations_subset(mismatches, root, a, c, d, b, 20);
-											increment_match_hash(hash[20], key, mismatches);                                            
+                                            graphlets.add(20, a, c, d, b);                                            
 										}
 									}
 								}
 								else  {                                    
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, b, a, c, d, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, b, a, c, d);
 										}
 										else  {
-                                            key = create_permutations_subset(mismatches, root, a, d, c, b, 20);
-											increment_match_hash(hash[20], key, mismatches);                                            
+                                            graphlets.add(20, a, d, c, b);                                            
 										}
 									}
 									else  {                                            
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, b, a, c, d, 21);
-											increment_match_hash(hash[21], key, mismatches);
+											graphlets.add(21, b, a, c, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, b, c, d, a, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, b, c, d, a);
 										}
 									}
 								}
@@ -962,44 +1549,36 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jk)  {
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, b, d, c, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, a, b, d, c);
 										}
 										else  {
-                                            key = create_permutations_subset(mismatches, root, b, c, d, a, 20);
-											increment_match_hash(hash[20], key, mismatches);                                            
+                                            graphlets.add(20, b, c, d, a);                                            
 										}
 									}
 									else  {                                            
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, b, d, c, 22);
-											increment_match_hash(hash[22], key, mismatches);
+											graphlets.add(22, a, b, d, c);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, d, a, b, c, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, d, a, b, c);
 										}
 									}
 								}
 								else  {
 									if (found_jl)  {
 										if (found_kl)  {
-                                            key = create_permutations_subset(mismatches, root, c, d, a, b, 20);
-											increment_match_hash(hash[20], key, mismatches);                                            
+                                            graphlets.add(20, c, d, a, b);                                            
 										}
 										else  {
-                                            key = create_permutations_subset(mismatches, root, a, c, b, d, 18);
-											increment_match_hash(hash[18], key, mismatches);											
+                                            graphlets.add(18, a, c, b, d);											
 										}
 									}
 									else  {                                            
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, b, a, d, c, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, b, a, d, c);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, b, d, a, c, 17);
-											increment_match_hash(hash[17], key, mismatches);
+											graphlets.add(17, b, d, a, c);
 										}
 									}
 								}
@@ -1010,44 +1589,36 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jk)  {
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, b, c, d, 24);
-											increment_match_hash(hash[24], key, mismatches);
+											graphlets.add(24, a, b, c, d);
 										}
 										else  {
-                                            key = create_permutations_subset(mismatches, root, b, d, c, a, 20);
-											increment_match_hash(hash[20], key, mismatches);                                            
+                                            graphlets.add(20, b, d, c, a);                                            
 										}
 									}
 									else  {
 										if (found_kl)  {
-                                            key = create_permutations_subset(mismatches, root, c, d, b, a, 20);
-											increment_match_hash(hash[20], key, mismatches);                                            
+                                            graphlets.add(20, c, d, b, a);                                            
 										}
 										else  {
-                                            key = create_permutations_subset(mismatches, root, a, d, b, c, 18);
-											increment_match_hash(hash[18], key, mismatches);											
+                                            graphlets.add(18, a, d, b, c);											
 										}
 									}
 								}
 								else  {                                  
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, b, c, d, 22);
-											increment_match_hash(hash[22], key, mismatches);
+											graphlets.add(22, a, b, c, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, c, a, b, d, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, c, a, b, d);
 										}
 									}
 									else  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, b, a, c, d, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, b, a, c, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, b, c, a, d, 17);
-											increment_match_hash(hash[17], key, mismatches);
+											graphlets.add(17, b, c, a, d);
 										}
 									}
 								}
@@ -1056,44 +1627,36 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jk)  {
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, b, c, d, 21);
-											increment_match_hash(hash[21], key, mismatches);
+											graphlets.add(21, a, b, c, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, a, c, d, b, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, a, c, d, b);
 										}
 									}
 									else  {                                            
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, b, d, c, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, a, b, d, c);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, a, d, b, c, 17);
-											increment_match_hash(hash[17], key, mismatches);
+											graphlets.add(17, a, d, b, c);
 										}
 									}
 								}
 								else  {                                    
 									if (found_jl)  {
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, b, c, d, 19);
-											increment_match_hash(hash[19], key, mismatches);
+											graphlets.add(19, a, b, c, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, a, c, b, d, 17);
-											increment_match_hash(hash[17], key, mismatches);
+											graphlets.add(17, a, c, b, d);
 										}
 									}
 									else  {             
 										if (found_kl)  {
-											key = create_permutations_subset(mismatches, root, a, b, c, d, 17);
-											increment_match_hash(hash[17], key, mismatches);
+											graphlets.add(17, a, b, c, d);
 										}
 										else  {
-											key = create_permutations_subset(mismatches, root, a, b, c, d, 16);
-											increment_match_hash(hash[16], key, mismatches);
+											graphlets.add(16, a, b, c, d);
 										}
 									}
 								}
@@ -1105,6 +1668,11 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
             }
         }
 		
+		#if GRAPHLETS_4
+		if (by_label)
+			label_rows.select_second(g, i);
+		#endif
+
 		for (unsigned j_=0; j_<g.adj[g_root].size(); j_++)  {
 			if (i_ == j_)  continue;
 			
@@ -1123,26 +1691,11 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 					d = g.nodes[l];
 					
 					#if GRAPHLETS_5
-                    bool found_ij(false), found_ik(false), found_jk(false), found_jl(false), found_kl(false);
-					unsigned t(0);
-					while(!found_ij && t<g.adj[i].size())
-						found_ij = (j == g.adj[i][t++]);
-					
-					t = 0;
-					while (!found_ik && t<g.adj[i].size())
-						found_ik = (k == g.adj[i][t++]);
-					
-					t = 0;
-					while (!found_jk && t<g.adj[j].size())
-						found_jk = (k == g.adj[j][t++]);
-					
-					t = 0;
-					while (!found_jl && t<g.adj[j].size())
-						found_jl = (l == g.adj[j][t++]);
-					
-					t = 0;
-					while(!found_kl && t<g.adj[k].size())
-						found_kl = (l == g.adj[k][t++]);
+                    bool found_ij = g.has_edge(i, j);
+                    bool found_ik = g.has_edge(i, k);
+                    bool found_jk = g.has_edge(j, k);
+                    bool found_jl = g.has_edge(j, l);
+                    bool found_kl = g.has_edge(k, l);
 
 					if (found_ij)  {
 						if (found_ik)  {
@@ -1150,28 +1703,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jl)  {
 									if (found_kl)  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, a, b, c, d, 58);
-											increment_match_hash(hash[58], key, mismatches);
+										    graphlets.add(58, a, b, c, d);
 									    }
                                     }
 									else  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, a, b, d, 57);
-											increment_match_hash(hash[57], key, mismatches);
+										    graphlets.add(57, c, a, b, d);
 									    }
                                     }
 								}
 								else  {
 									if (found_kl)  {
                                         if (i_ < k_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, a, c, d, 57);
-											increment_match_hash(hash[57], key, mismatches);
+										    graphlets.add(57, b, a, c, d);
 									    }
                                     }
 									else  {
                                         if (j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, c, a, d, 54);
-											increment_match_hash(hash[54], key, mismatches);
+										    graphlets.add(54, b, c, a, d);
 									    }
                                     }
 								}
@@ -1180,28 +1729,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jl)  {
 									if (found_kl)  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, a, b, c, d, 56);
-											increment_match_hash(hash[56], key, mismatches);
+										    graphlets.add(56, a, b, c, d);
 									    }
                                     }
 									else  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, a, b, d, 53);
-											increment_match_hash(hash[53], key, mismatches);
+										    graphlets.add(53, c, a, b, d);
 									    }
                                     }
 								}
 								else  {
 									if (found_kl)  {
                                         if (i_ < k_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, a, c, d, 53);
-											increment_match_hash(hash[53], key, mismatches);
+										    graphlets.add(53, b, a, c, d);
 									    }
                                     }
 									else  {
                                         if (j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, c, a, d, 49);
-											increment_match_hash(hash[49], key, mismatches);
+										    graphlets.add(49, b, c, a, d);
 									    }
                                     }
 								}
@@ -1212,28 +1757,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jl)  {
 									if (found_kl)  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, a, c, d, 56);
-											increment_match_hash(hash[56], key, mismatches);
+										    graphlets.add(56, b, a, c, d);
 									    }
                                     }
 									else  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, b, a, d, 53);
-											increment_match_hash(hash[53], key, mismatches);
+										    graphlets.add(53, c, b, a, d);
 									    }
                                     }
 								}
 								else  {
 									if (found_kl)  {
                                         if (i_ < k_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, a, c, d, 55);
-											increment_match_hash(hash[55], key, mismatches);
+										    graphlets.add(55, b, a, c, d);
 									    }
                                     }
 									else  {
                                         if (j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, b, a, d, 47);
-											increment_match_hash(hash[47], key, mismatches);
+										    graphlets.add(47, c, b, a, d);
 									    }
                                     }
 								}
@@ -1242,28 +1783,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jl)  {
 									if (found_kl)  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, a, b, d, 52);
-											increment_match_hash(hash[52], key, mismatches);
+										    graphlets.add(52, c, a, b, d);
 									    }
                                     }
 									else  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, a, b, d, 50);
-											increment_match_hash(hash[50], key, mismatches);
+										    graphlets.add(50, c, a, b, d);
 									    }
                                     }
 								}
 								else  {
 									if (found_kl)  {
                                         if (i_ < k_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, a, c, d, 48);
-											increment_match_hash(hash[48], key, mismatches);
+										    graphlets.add(48, b, a, c, d);
 									    }
                                     }
 									else  {
                                         if (j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, b, a, d, 45);
-											increment_match_hash(hash[45], key, mismatches);
+										    graphlets.add(45, c, b, a, d);
 									    }
                                     }
 								}
@@ -1276,28 +1813,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jl)  {
 									if (found_kl)  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, a, b, d, 56);
-											increment_match_hash(hash[56], key, mismatches);
+										    graphlets.add(56, c, a, b, d);
 									    }
                                     }
 									else  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, a, b, d, 55);
-											increment_match_hash(hash[55], key, mismatches);
+										    graphlets.add(55, c, a, b, d);
 									    }
                                     }
 								}
 								else  {
 									if (found_kl)  {
                                         if (i_ < k_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, c, a, d, 53);
-											increment_match_hash(hash[53], key, mismatches);
+										    graphlets.add(53, b, c, a, d);
 									    }
                                     }
 									else  {
                                         if (j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, c, a, d, 47);
-											increment_match_hash(hash[47], key, mismatches);
+										    graphlets.add(47, b, c, a, d);
 									    }
                                     }
 								}
@@ -1306,28 +1839,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jl)  {
 									if (found_kl)  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, a, c, d, 52);
-											increment_match_hash(hash[52], key, mismatches);
+										    graphlets.add(52, b, a, c, d);
 									    }
                                     }
 									else  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, a, b, d, 48);
-											increment_match_hash(hash[48], key, mismatches);
+										    graphlets.add(48, c, a, b, d);
 									    }
                                     }
 								}
 								else  {
 									if (found_kl)  {
                                         if (i_ < k_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, a, c, d, 50);
-											increment_match_hash(hash[50], key, mismatches);
+										    graphlets.add(50, b, a, c, d);
 									    }
                                     }
 									else  {
                                         if (j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, c, a, d, 45);
-											increment_match_hash(hash[45], key, mismatches);
+										    graphlets.add(45, b, c, a, d);
 									    }
                                     }
 								}
@@ -1338,28 +1867,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jl)  {
 									if (found_kl)  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, a, b, c, d, 52);
-											increment_match_hash(hash[52], key, mismatches);
+										    graphlets.add(52, a, b, c, d);
                                         }
                                     }
 									else  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, b, a, d, 48);
-											increment_match_hash(hash[48], key, mismatches);
+										    graphlets.add(48, c, b, a, d);
 									    }
                                     }
 								}
 								else  {
 									if (found_kl)  {
                                         if (i_ < k_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, c, a, d, 48);
-											increment_match_hash(hash[48], key, mismatches);
+										    graphlets.add(48, b, c, a, d);
 									    }
                                     }
 									else  {
                                         if (j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, c, a, d, 44);
-											increment_match_hash(hash[44], key, mismatches);
+										    graphlets.add(44, b, c, a, d);
 									    }
                                     }
 								}
@@ -1368,28 +1893,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 								if (found_jl)  {
 									if (found_kl)  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, a, b, c, d, 51);
-											increment_match_hash(hash[51], key, mismatches);
+										    graphlets.add(51, a, b, c, d);
 									    }
                                     }
 									else  {
                                         if (i_ < j_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, c, a, b, d, 46);
-											increment_match_hash(hash[46], key, mismatches);
+										    graphlets.add(46, c, a, b, d);
 									    }
                                     }
 								}
 								else  {
 									if (found_kl)  {
                                         if (i_ < k_ && j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, a, c, d, 46);
-											increment_match_hash(hash[46], key, mismatches);
+										    graphlets.add(46, b, a, c, d);
 									    }
                                     }
 									else  {
                                         if (j_ < k_)  {
-										    key = create_permutations_subset(mismatches, root, b, c, a, d, 43);
-											increment_match_hash(hash[43], key, mismatches);
+										    graphlets.add(43, b, c, a, d);
 									    }
                                     }
 								}
@@ -1401,42 +1922,39 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 			}
 			
 			// 4-graphlets, case 0112
+			#if GRAPHLETS_4
+			if (by_label)
+				label_rows.count_second(g, j, g.has_edge(i, j), i_ < j_);
+			#endif
+
 			for (unsigned k_=0; k_<g.adj[i].size(); k_++)  {
 				k = g.adj[i][k_];
 				if (2 != dist[k])  continue;
 				c = g.nodes[k];
 				
 				#if GRAPHLETS_4
-                bool found_ij(false), found_jk(false);
-				unsigned t(0);
-				while(!found_ij && t<g.adj[i].size())
-					found_ij = (j == g.adj[i][t++]);
-				
-				t = 0;
-				while (!found_jk && t<g.adj[j].size())
-					found_jk = (k == g.adj[j][t++]);
-
-				if (found_ij)  {                    
-					if (found_jk)  {						
-						if(i_ < j_)  {
-							key = create_permutations_subset(mismatches, root, a, b, c, ZERO_CHAR, 13);
-							increment_match_hash(hash[13], key, mismatches);
-						}						
-                    } else  {
-						key = create_permutations_subset(mismatches, root, b, a, c, ZERO_CHAR, 11);
-						increment_match_hash(hash[11], key, mismatches);
-					}
-				} else  {
-					if (found_jk)  {						
-						if(i_ < j_)  {
-							key = create_permutations_subset(mismatches, root, a, b, c, ZERO_CHAR, 12);
-							increment_match_hash(hash[12], key, mismatches);
-						}						
+				if (!by_label)  {
+					bool found_ij = g.has_edge(i, j);
+					bool found_jk = g.has_edge(j, k);
+
+					if (found_ij)  {                    
+						if (found_jk)  {						
+							if(i_ < j_)  {
+								graphlets.add(13, a, b, c, ZERO_CHAR);
+							}						
+						} else  {
+							graphlets.add(11, b, a, c, ZERO_CHAR);
+						}
 					} else  {
-						key = create_permutations_subset(mismatches, root, b, a, c, ZERO_CHAR, 6);
-						increment_match_hash(hash[6], key, mismatches);
+						if (found_jk)  {						
+							if(i_ < j_)  {
+								graphlets.add(12, a, b, c, ZERO_CHAR);
+							}						
+						} else  {
+							graphlets.add(6, b, a, c, ZERO_CHAR);
+						}
 					}
-				}				
+				}
 				#endif
 				
 				// 5-graphlets, case 01122, Type 1
@@ -1446,49 +1964,33 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 					d = g.nodes[l];
 					
 					#if GRAPHLETS_5					
-                    bool found_ij(false), found_jk(false), found_jl(false), found_kl(false);
-					unsigned t(0);
-					while(!found_ij && t<g.adj[i].size())
-						found_ij = (j == g.adj[i][t++]);
-					
-					t = 0;
-					while (!found_jk && t<g.adj[j].size())
-						found_jk = (k == g.adj[j][t++]);
-					
-					t = 0;
-					while (!found_jl && t<g.adj[j].size())
-						found_jl = (l == g.adj[j][t++]);
-					
-					t = 0;
-					while (!found_kl && t<g.adj[k].size())
-						found_kl = (l == g.adj[k][t++]);
+                    bool found_ij = g.has_edge(i, j);
+                    bool found_jk = g.has_edge(j, k);
+                    bool found_jl = g.has_edge(j, l);
+                    bool found_kl = g.has_edge(k, l);
 
 					if (!found_jl && !found_jk)  {
 						if (found_ij)  {
 							if (found_kl)  {
 								if(k_ < l_)  {
-									key = create_permutations_subset(mismatches, root, b, a, c, d, 42);
-									increment_match_hash(hash[42], key, mismatches);
+									graphlets.add(42, b, a, c, d);
 								}
 							}
 							else  {
 								if(k_ < l_)  {
-									key = create_permutations_subset(mismatches, root, b, a, c, d, 41);
-									increment_match_hash(hash[41], key, mismatches);
+									graphlets.add(41, b, a, c, d);
 								}
 							}
 						}
 						else  {
 							if (found_kl)  {
 								if(k_ < l_)  {
-									key = create_permutations_subset(mismatches, root, b, a, c, d, 40);
-									increment_match_hash(hash[40], key, mismatches);
+									graphlets.add(40, b, a, c, d);
 								}
 							}
 							else  {
 								if(k_ < l_)  {
-									key = create_permutations_subset(mismatches, root, b, a, c, d, 39);
-									increment_match_hash(hash[39], key, mismatches);
+									graphlets.add(39, b, a, c, d);
 								}
 							}
 						}
@@ -1503,50 +2005,34 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 					d = g.nodes[l];
 					
 					#if GRAPHLETS_5
-                    bool found_ij(false), found_il(false), found_jk(false), found_kl(false);
-					unsigned t(0);
-					while(!found_ij && t<g.adj[i].size())
-						found_ij = (j == g.adj[i][t++]);
-					
-					t = 0;
-					while(!found_il && t<g.adj[i].size())
-						found_il = (l == g.adj[i][t++]);
-					
-					t = 0;
-					while (!found_jk && t<g.adj[j].size())
-						found_jk = (k == g.adj[j][t++]);
-					
-					t = 0;
-					while (!found_kl && t<g.adj[k].size())
-						found_kl = (l == g.adj[k][t++]);
+                    bool found_ij = g.has_edge(i, j);
+                    bool found_il = g.has_edge(i, l);
+                    bool found_jk = g.has_edge(j, k);
+                    bool found_kl = g.has_edge(k, l);
 
 					if (found_ij)  {
 						if (found_il)  {
 							if (found_jk)  {
 								if (found_kl)  {
 									if(i_ < j_ && k < l)  {
-										key = create_permutations_subset(mismatches, root, a, b, c, d, 38);
-										increment_match_hash(hash[38], key, mismatches);
+										graphlets.add(38, a, b, c, d);
 									}
 								}
 								else  {
 									if(i_ < j_ && k < l)  {
-										key = create_permutations_subset(mismatches, root, a, b, c, d, 36);
-										increment_match_hash(hash[36], key, mismatches);
+										graphlets.add(36, a, b, c, d);
 									}
 								}
 							}
 							else {
 								if (found_kl)  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, b, a, c, d, 37);
-										increment_match_hash(hash[37], key, mismatches);
+										graphlets.add(37, b, a, c, d);
 									}
 								}
 								else  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, b, a, c, d, 32);
-										increment_match_hash(hash[32], key, mismatches);
+										graphlets.add(32, b, a, c, d);
 									}
 								}	
 							}
@@ -1555,28 +2041,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 							if (found_jk)  {
 								if (found_kl)  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, a, b, d, c, 37);
-										increment_match_hash(hash[37], key, mismatches);
+										graphlets.add(37, a, b, d, c);
 									}
 								}
 								else  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, a, b, d, c, 32);
-										increment_match_hash(hash[32], key, mismatches);
+										graphlets.add(32, a, b, d, c);
 									}
 								}
 							}
 							else  {
 								if (found_kl)  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, a, b, c, d, 31);
-										increment_match_hash(hash[31], key, mismatches);                                        
+										graphlets.add(31, a, b, c, d);                                        
 									}
 								}
 								else  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, a, b, c, d, 28);
-										increment_match_hash(hash[28], key, mismatches);                                        
+										graphlets.add(28, a, b, c, d);                                        
 									}
 								}
 							}							
@@ -1587,28 +2069,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 							if (found_jk)  {
 								if (found_kl)  {
 									if(i_ < j_ && k < l)  {
-										key = create_permutations_subset(mismatches, root, a, b, c, d, 35);
-										increment_match_hash(hash[35], key, mismatches);
+										graphlets.add(35, a, b, c, d);
 									}
 								}
 								else  {
 									if(i_ < j_ && k < l)  {
-										key = create_permutations_subset(mismatches, root, a, b, c, d, 34);
-										increment_match_hash(hash[34], key, mismatches);
+										graphlets.add(34, a, b, c, d);
 									}
 								}
 							}
 							else {
 								if (found_kl)  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, b, a, c, d, 33);
-										increment_match_hash(hash[33], key, mismatches);
+										graphlets.add(33, b, a, c, d);
 									}
 								}
 								else  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, b, a, c, d, 30);
-										increment_match_hash(hash[30], key, mismatches);
+										graphlets.add(30, b, a, c, d);
 									}
 								}
 							}
@@ -1617,28 +2095,24 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 							if (found_jk)  {
 								if (found_kl)  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, a, b, d, c, 33);
-										increment_match_hash(hash[33], key, mismatches);
+										graphlets.add(33, a, b, d, c);
 									}
 								}
 								else  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, a, b, d, c, 30);
-										increment_match_hash(hash[30], key, mismatches);
+										graphlets.add(30, a, b, d, c);
 									}
 								}
 							}
 							else  {
 								if (found_kl)  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, a, b, c, d, 29);
-										increment_match_hash(hash[29], key, mismatches);                                        
+										graphlets.add(29, a, b, c, d);                                        
 									}
 								}
 								else  {
 									if(i_ < j_)  {
-										key = create_permutations_subset(mismatches, root, a, b, c, d, 27);
-										increment_match_hash(hash[27], key, mismatches);                                        
+										graphlets.add(27, a, b, c, d);                                        
 									}
 								}
 							}							
@@ -1655,46 +2129,30 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 					d = g.nodes[l];
 					
 					#if GRAPHLETS_5
-                    bool found_il(false), found_jl(false), found_ij(false), found_jk(false);
-					unsigned t(0);
-					while (!found_il && t<g.adj[i].size())
-						found_il = (l == g.adj[i][t++]);
-					
-					t = 0;
-					while (!found_jl && t<g.adj[j].size())
-						found_jl = (l == g.adj[j][t++]);
-					
-					t = 0;
-					while(!found_ij && t<g.adj[i].size())
-						found_ij = (j == g.adj[i][t++]);
-					
-					t = 0;
-					while (!found_jk && t<g.adj[j].size())
-						found_jk = (k == g.adj[j][t++]);
+                    bool found_il = g.has_edge(i, l);
+                    bool found_jl = g.has_edge(j, l);
+                    bool found_ij = g.has_edge(i, j);
+                    bool found_jk = g.has_edge(j, k);
 
 					if (!found_il && !found_jl)  {
 						if (found_ij)  {
 							if (found_jk)  {
 								if (i_ < j_)  {
-									key = create_permutations_subset(mismatches, root, a, b, c, d, 66);
-									increment_match_hash(hash[66], key, mismatches);
+									graphlets.add(66, a, b, c, d);
 								}
 							}
 							else  {
-								key = create_permutations_subset(mismatches, root, b, a, c, d, 64);
-								increment_match_hash(hash[64], key, mismatches);
+								graphlets.add(64, b, a, c, d);
 							}
 						}
 						else  {
 							if (found_jk)  {
 								if (i_ < j_)  {
-									key = create_permutations_subset(mismatches, root, a, b, c, d, 65);
-									increment_match_hash(hash[65], key, mismatches);
+									graphlets.add(65, a, b, c, d);
 								}
 							}
 							else  {
-								key = create_permutations_subset(mismatches, root, b, a, c, d, 63);
-								increment_match_hash(hash[63], key, mismatches);
+								graphlets.add(63, b, a, c, d);
 							}
 						}
 					}
@@ -1702,6 +2160,11 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 				}					
 			}
 		}
+
+		#if GRAPHLETS_4
+		if (by_label)
+			label_rows.add_second(graphlets, a);
+		#endif
 		
 		// 3-graphlets, case 012
 		for (unsigned j_=0; j_<g.adj[i].size(); j_++)  {
@@ -1710,8 +2173,7 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 			b = g.nodes[j];
 			
 			#if GRAPHLETS_3
-			key = create_permutations_subset(mismatches, root, a, b, ZERO_CHAR, ZERO_CHAR, 2);
-			increment_match_hash(hash[2], key, mismatches);
+			graphlets.add(2, a, b, ZERO_CHAR, ZERO_CHAR);
 			#endif
 			
 			// 4-graphlets, case 0122
@@ -1721,17 +2183,12 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 				c = g.nodes[k];
 				
 				#if GRAPHLETS_4
-				bool found(false);
-				unsigned t(0);
-				while (!found && t<g.adj[j].size())
-					found = (k == g.adj[j][t++]);
+				bool found = g.has_edge(j, k);
 				
 				if (found)  {
-					key = create_permutations_subset(mismatches, root, a, b, c, ZERO_CHAR, 9);
-					increment_match_hash(hash[9], key, mismatches);
+					graphlets.add(9, a, b, c, ZERO_CHAR);
 				} else  {
-					key = create_permutations_subset(mismatches, root, a, b, c, ZERO_CHAR, 7);
-					increment_match_hash(hash[7], key, mismatches);
+					graphlets.add(7, a, b, c, ZERO_CHAR);
 				}
 				#endif
 				
@@ -1742,59 +2199,42 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 					d = g.nodes[l];
 					
 					#if GRAPHLETS_5
-					bool found_jk(false), found_jl(false), found_kl(false);
-					unsigned t(0);
-					while (!found_jk && t<g.adj[j].size())
-						found_jk = (k == g.adj[j][t++]);
-					
-					t = 0;
-					while (!found_jl && t<g.adj[j].size())
-						found_jl = (l == g.adj[j][t++]);
-					
-					t = 0;
-					while (!found_kl && t<g.adj[k].size())
-						found_kl = (l == g.adj[k][t++]);
+					bool found_jk = g.has_edge(j, k);
+					bool found_jl = g.has_edge(j, l);
+					bool found_kl = g.has_edge(k, l);
 					if (found_jk)  {
 						if (found_jl)  {
 							if (found_kl)  {
-								key = create_permutations_subset(mismatches, root, a, b, c, d, 62);
-								increment_match_hash(hash[62], key, mismatches);
+								graphlets.add(62, a, b, c, d);
 							}
 							else  {
-								key = create_permutations_subset(mismatches, root, a, b, c, d, 61);
-								increment_match_hash(hash[61], key, mismatches);
+								graphlets.add(61, a, b, c, d);
 							}
 						}
 						else  {
 							if (found_kl)  {
-								key = create_permutations_subset(mismatches, root, a, c, b, d, 61);
-								increment_match_hash(hash[61], key, mismatches);
+								graphlets.add(61, a, c, b, d);
 							}
 							else  {
-								key = create_permutations_subset(mismatches, root, a, d, b, c, 60);
-								increment_match_hash(hash[60], key, mismatches);
+								graphlets.add(60, a, d, b, c);
 							}							
 						}
 					}
 					else  {
 						if (found_jl)  {
 							if (found_kl)  {
-								key = create_permutations_subset(mismatches, root, a, d, b, c, 61);
-								increment_match_hash(hash[61], key, mismatches);
+								graphlets.add(61, a, d, b, c);
 							}
 							else  {
-								key = create_permutations_subset(mismatches, root, a, c, b, d, 60);
-								increment_match_hash(hash[60], key, mismatches);
+								graphlets.add(60, a, c, b, d);
 							}
 						}
 						else  {
 							if (found_kl)  {
-								key = create_permutations_subset(mismatches, root, a, b, c, d, 60);
-								increment_match_hash(hash[60], key, mismatches);
+								graphlets.add(60, a, b, c, d);
 							}
 							else  {
-								key = create_permutations_subset(mismatches, root, a, b, c, d, 59);
-								increment_match_hash(hash[59], key, mismatches);
+								graphlets.add(59, a, b, c, d);
 							}							
 						}						
 					}
@@ -1815,42 +2255,29 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 					d = g.nodes[l];
 					
 					#if GRAPHLETS_5
-					bool found_il(false), found_jk(false), found_kl(false);
-					unsigned t(0);
-					while (!found_il && t<g.adj[i].size())
-						found_il = (l == g.adj[i][t++]);
-					
-					t = 0;
-					while(!found_jk && t<g.adj[j].size())
-						found_jk = (k == g.adj[j][t++]);
-					
-					t = 0;
-					while (!found_kl && t<g.adj[k].size())
-						found_kl = (l == g.adj[k][t++]);
+					bool found_il = g.has_edge(i, l);
+					bool found_jk = g.has_edge(j, k);
+					bool found_kl = g.has_edge(k, l);
 
                     if (!found_il)  {
 					    if (found_jk)  {
 						    if (found_kl)  {
                                 if (j_ < k_)  {
-							        key = create_permutations_subset(mismatches, root, a, b, c, d, 70);
-									increment_match_hash(hash[70], key, mismatches);
+							        graphlets.add(70, a, b, c, d);
 						        }
                             }
 						    else  {
-							    key = create_permutations_subset(mismatches, root, a, c, b, d, 69);
-								increment_match_hash(hash[69], key, mismatches);
+							    graphlets.add(69, a, c, b, d);
                             }
 					    }
 					    else  {
 						    if (found_kl)  {
                                 if (j_ < k_)  {
-							        key = create_permutations_subset(mismatches, root, a, b, c, d, 68);
-									increment_match_hash(hash[68], key, mismatches);
+							        graphlets.add(68, a, b, c, d);
 						        }
                             }
 						    else  {
-							    key = create_permutations_subset(mismatches, root, a, c, b, d, 67);
-								increment_match_hash(hash[67], key, mismatches);
+							    graphlets.add(67, a, c, b, d);
                             }
 					    }
                     }
@@ -1866,16 +2293,11 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 				c = g.nodes[k];
 				
 				#if GRAPHLETS_4
-				bool found_ik(false);
-				unsigned t(0);
-				while (!found_ik && t<g.adj[i].size())  {
-					found_ik = (k == g.adj[i][t++]);
-				}
+				bool found_ik = g.has_edge(i, k);
 				
                 // Verify that local path does not classifies under previous graphlet types.
 				if (!found_ik)  {
-                    key = create_permutations_subset(mismatches, root, a, b, c, ZERO_CHAR, 5);
-					increment_match_hash(hash[5], key, mismatches);
+                    graphlets.add(5, a, b, c, ZERO_CHAR);
                 }
 				#endif
 				
@@ -1887,28 +2309,17 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 					d = g.nodes[l];
 		
 					#if GRAPHLETS_5
-					bool found_il(false), found_ik(false), found_kl(false);
-					unsigned t(0);
-					while (!found_il && t<g.adj[i].size())
-						found_il = (l == g.adj[i][t++]);
-					
-                    t = 0;
-                    while (!found_ik && t<g.adj[i].size())
-                        found_ik = (k == g.adj[i][t++]);
-					
-					t = 0;
-					while (!found_kl && t<g.adj[k].size())
-						found_kl = (l == g.adj[k][t++]);
+					bool found_il = g.has_edge(i, l);
+					bool found_ik = g.has_edge(i, k);
+					bool found_kl = g.has_edge(k, l);
 
                     // Verify that local path does not classifies under previous graphlet types.
                     if(!found_il && !found_ik)  {
 					    if(found_kl)  {
-						    key = create_permutations_subset(mismatches, root, a, b, c, d, 72);
-							increment_match_hash(hash[72], key, mismatches);
+						    graphlets.add(72, a, b, c, d);
 					    }
 					    else  {
-						    key = create_permutations_subset(mismatches, root, a, b, c, d, 71);
-							increment_match_hash(hash[71], key, mismatches);
+						    graphlets.add(71, a, b, c, d);
 					    }
                     }
 					#endif
@@ -1922,42 +2333,28 @@ vector<map<Key,MismatchInfo> > GraphKernel::get_graphlets_counts(SimpleGraph &g,
 					d = g.nodes[l];
 					
 					#if GRAPHLETS_5
-					bool found_ik(false), found_il(false), found_jl(false);
-					unsigned t(0);
-					while (!found_ik && t<g.adj[i].size())
-						found_ik = (k == g.adj[i][t++]);
-
-                    t = 0;
-					while (!found_il && t<g.adj[i].size())
-						found_il = (l == g.adj[i][t++]);
-					
-					t = 0;
-					while (!found_jl && t<g.adj[j].size())
-						found_jl = (l == g.adj[j][t++]);
+					bool found_ik = g.has_edge(i, k);
+					bool found_il = g.has_edge(i, l);
+					bool found_jl = g.has_edge(j, l);
 					
                     // Verify that local path does not classifies under previous graphlet types.
                     if(!found_ik && !found_il && !found_jl)  {
-					    key = create_permutations_subset(mismatches, root, a, b, c, d, 73);
-						increment_match_hash(hash[73], key, mismatches);
+					    graphlets.add(73, a, b, c, d);
                     }
 					#endif
 				}
 			}
 		}
     } 
-    
-    if (NORMALIZE)
-        normalize_spectral(hash);
-
-    return hash;
+    graphlets.flush();
 }
 
 // Add inexact graphlets by allowing vertex and edge label mismatches upto VLM.
-void GraphKernel::add_vertex_label_mismatch_counts(map<Key,MismatchInfo> &hash, map<Key,MismatchInfo> &mismatch_hash, unsigned long g_type, int VLM, bool option)  {
+void GraphKernel::add_vertex_label_mismatch_counts(MismatchHash &hash, MismatchHash &mismatch_hash, map<Key, list<Key> > &vl_mismatch_neighborhood, unsigned long g_type, int VLM, bool option)  {
 	// Update counts to include vertex label mismacthes.
 	if(VLM > 0 && ((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5)))  {
         // For each exact graphlet, generate all mismatch graphlets upto vertex label distance VLM.
-        for (map<Key,MismatchInfo>::iterator git = hash.begin(); git != hash.end(); git++)  {
+        for (MismatchHash::iterator git = hash.begin(); git != hash.end(); git++)  {
             if (hash[git->first].matches > 0)
                 generate_vertex_label_mismatch_graphlets(vl_mismatch_neighborhood, hash, mismatch_hash, git->first, g_type, ALPHABET_ROOT, ALPHABET, sim_vlm_matrix, VLM);
             else  {
@@ -1968,10 +2365,13 @@ void GraphKernel::add_vertex_label_mismatch_counts(map<Key,MismatchInfo> &hash,
     }
 }
 
-void GraphKernel::update_label_mismatch_counts(map<Key,MismatchInfo> &hash, map<Key,MismatchInfo> &mismatch_hash, unsigned long g_type, bool option, int VLM, bool eq)  { 
+void GraphKernel::update_label_mismatch_counts(MismatchHash &hash, MismatchHash &mismatch_hash, unsigned long g_type, bool option, int VLM, bool eq)  { 
     if((VLM > 0) && ((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5)))  {
+        add_permutation_subsets(hash, g_type);
+        add_permutation_subsets(mismatch_hash, g_type);
+
         // Update mismatch counts for newly created graphlets.
-        for (map<Key,MismatchInfo>::iterator git = hash.begin(); git != hash.end(); git++)  {
+        for (MismatchHash::iterator git = hash.begin(); git != hash.end(); git++)  {
             if (option)  {
                 update_mismatch_count(hash, git->first, (hash[git->first].matches + hash[git->first].mismatches), g_type, sim_vlm_matrix, VLM, eq);
                 update_mismatch_count(mismatch_hash, git->first, (hash[git->first].matches + hash[git->first].mismatches), g_type, sim_vlm_matrix, VLM, eq);
@@ -1982,17 +2382,18 @@ void GraphKernel::update_label_mismatch_counts(map<Key,MismatchInfo> &hash, map<
             }
         }
         // Merge all non-zero graphlets into one hashable list. 
-        for (map<Key,MismatchInfo>::iterator git = mismatch_hash.begin(); git != mismatch_hash.end(); git++)  {
+        for (MismatchHash::iterator git = mismatch_hash.begin(); git != mismatch_hash.end(); git++)  {
             insert_mismatch_counts(hash, mismatch_hash, git->first);
         }
+        hash.sort_by_key();
         mismatch_hash.clear();
     }
 }
 
 // Add inexact graphlets by allowing edge insertions and deletions upto EM.
-void GraphKernel::add_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash)  {
-    map<Key,MismatchInfo> T;
-    vector<map<Key,MismatchInfo> > mismatch_hash(GRAPHLET_TYPES, T);
+void GraphKernel::add_edge_mismatch_counts(vector<MismatchHash> &hash)  {
+    MismatchHash T;
+    vector<MismatchHash> mismatch_hash(GRAPHLET_TYPES, T);
     unsigned vindex = 0;
     list<pair <unsigned long, Key> > L;
     float mult_factor;
@@ -2000,7 +2401,7 @@ void GraphKernel::add_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash)
     if (EM > 0)  {
         for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
             if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  { 
-                for (map<Key,MismatchInfo>::iterator it = hash[g_type].begin(); it != hash[g_type].end(); it++)  { 
+                for (MismatchHash::iterator it = hash[g_type].begin(); it != hash[g_type].end(); it++)  { 
                     vindex = 0;
                     vector<list<pair <unsigned long, Key> > > EM_set(EM, L);
                     pair <unsigned long, Key> p (g_type, it->first); 
@@ -2026,14 +2427,13 @@ void GraphKernel::add_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash)
                                 }
                             }
                             if (!already_added)  { 
-                                vector<Key> mismatches;
                                 char root, a, b, c, d;
 			                    initialize_vertices_labels(list_it->second, root, a, b, c, d);
-			                    Key k = create_permutations_subset(mismatches, root, a, b, c, d, list_it->first);
+			                    Key k = canonical_key(root, a, b, c, d, list_it->first);
                                 if (k != list_it->second)  {
                                     cerr << "ERROR: Graphlets keys do not match " << print_key(k) << " vs " << print_key(list_it->second) << " ; " << list_it->first << endl; exit(1);
                                 }
-                                increment_edge_mismatch_hash(hash[list_it->first], mismatch_hash[list_it->first], list_it->second, mult_factor, mismatches);
+                                increment_edge_mismatch_hash(hash[list_it->first], mismatch_hash[list_it->first], list_it->second, mult_factor);
                             }
                         }
                     }
@@ -2042,9 +2442,10 @@ void GraphKernel::add_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash)
         }
         for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
             if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
-                for (map<Key,MismatchInfo>::iterator mit = mismatch_hash[g_type].begin(); mit != mismatch_hash[g_type].end(); mit++)  {
+                for (MismatchHash::iterator mit = mismatch_hash[g_type].begin(); mit != mismatch_hash[g_type].end(); mit++)  {
 					insert_mismatch_counts(hash[g_type], mismatch_hash[g_type], mit->first);
                 }
+                hash[g_type].sort_by_key();
             }
         }
         mismatch_hash.clear();
@@ -2052,9 +2453,9 @@ void GraphKernel::add_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash)
 }
 
 // Add inexact graphlets by allowing 1-edge insertion and deletion.
-void GraphKernel::add_1_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash)  {
-    map<Key,MismatchInfo> T;
-    vector<map<Key,MismatchInfo> > mismatch_hash(GRAPHLET_TYPES, T);
+void GraphKernel::add_1_edge_mismatch_counts(vector<MismatchHash> &hash)  {
+    MismatchHash T;
+    vector<MismatchHash> mismatch_hash(GRAPHLET_TYPES, T);
     unsigned vindex = 0;
     list<pair <unsigned long, Key> > L;
     float mult_factor;
@@ -2062,7 +2463,7 @@ void GraphKernel::add_1_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &has
     if (EM > 0)  {
         for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
             if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  { 
-                for (map<Key,MismatchInfo>::iterator it = hash[g_type].begin(); it != hash[g_type].end(); it++)  { 
+                for (MismatchHash::iterator it = hash[g_type].begin(); it != hash[g_type].end(); it++)  { 
                     vindex = 0;
                     vector<list<pair <unsigned long, Key> > > EM_set(EM, L);
                     pair <unsigned long, Key> p (g_type, it->first); 
@@ -2076,23 +2477,23 @@ void GraphKernel::add_1_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &has
                     // Add graphlets within edge mismacth neighborhood of current graphlet.
                     EM_set[0].sort();
 					for (list_it = EM_set[0].begin(); list_it != EM_set[0].end(); list_it++)  {
-                        vector<Key> mismatches;
                         char root, a, b, c, d;
 			            initialize_vertices_labels(list_it->second, root, a, b, c, d);
-			            Key k = create_permutations_subset(mismatches, root, a, b, c, d, list_it->first);
+			            Key k = canonical_key(root, a, b, c, d, list_it->first);
                         if (k != list_it->second)  {
                             cerr << "ERROR: Graphlets keys do not match " << print_key(k) << " vs " << print_key(list_it->second) << endl; exit(1);
                         }
-                        increment_edge_mismatch_hash(hash[list_it->first], mismatch_hash[list_it->first], list_it->second, mult_factor, mismatches);
+                        increment_edge_mismatch_hash(hash[list_it->first], mismatch_hash[list_it->first], list_it->second, mult_factor);
                     }
                 }
             }
         }
         for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
             if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
-                for (map<Key,MismatchInfo>::iterator mit = mismatch_hash[g_type].begin(); mit != mismatch_hash[g_type].end(); mit++)  {                    
+                for (MismatchHash::iterator mit = mismatch_hash[g_type].begin(); mit != mismatch_hash[g_type].end(); mit++)  {                    
 					insert_mismatch_counts(hash[g_type], mismatch_hash[g_type], mit->first);
                 }
+                hash[g_type].sort_by_key();
             }
         }
         mismatch_hash.clear();
@@ -2100,9 +2501,9 @@ void GraphKernel::add_1_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &has
 }
 
 // Add inexact graphlets by allowing 2-edge insertions and deletions.
-void GraphKernel::add_2_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash)  {
-    map<Key,MismatchInfo> T;
-    vector<map<Key,MismatchInfo> > mismatch_hash(GRAPHLET_TYPES, T);
+void GraphKernel::add_2_edge_mismatch_counts(vector<MismatchHash> &hash)  {
+    MismatchHash T;
+    vector<MismatchHash> mismatch_hash(GRAPHLET_TYPES, T);
     unsigned vindex = 0;
     list<pair <unsigned long, Key> > L;
     float mult_factor;
@@ -2110,7 +2511,7 @@ void GraphKernel::add_2_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &has
     if (EM > 0)  {
         for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
             if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  { 
-                for (map<Key,MismatchInfo>::iterator it = hash[g_type].begin(); it != hash[g_type].end(); it++)  { 
+                for (MismatchHash::iterator it = hash[g_type].begin(); it != hash[g_type].end(); it++)  { 
                     vindex = 0;
                     vector<list<pair <unsigned long, Key> > > EM_set(EM, L);
                     pair <unsigned long, Key> p (g_type, it->first); 
@@ -2136,14 +2537,13 @@ void GraphKernel::add_2_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &has
                                 }
                             }
                             if (!already_added)  {
-                                vector<Key> mismatches;
                                 char root, a, b, c, d;
 			                    initialize_vertices_labels(list_it->second, root, a, b, c, d);
-			                    Key k = create_permutations_subset(mismatches, root, a, b, c, d, list_it->first);
+			                    Key k = canonical_key(root, a, b, c, d, list_it->first);
                                 if (k != list_it->second)  {
                                     cerr << "ERROR: Graphlets keys do not match " << print_key(k) << " vs " << print_key(list_it->second) << endl; exit(1);
                                 }
-                                increment_edge_mismatch_hash(hash[list_it->first], mismatch_hash[list_it->first], list_it->second, mult_factor, mismatches);
+                                increment_edge_mismatch_hash(hash[list_it->first], mismatch_hash[list_it->first], list_it->second, mult_factor);
                             }
                         }
                     }
@@ -2152,36 +2552,37 @@ void GraphKernel::add_2_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &has
         }
         for (unsigned g_type=0; g_type<GRAPHLET_TYPES; g_type++)  {
             if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
-                for (map<Key,MismatchInfo>::iterator mit = mismatch_hash[g_type].begin(); mit != mismatch_hash[g_type].end(); mit++)  {
+                for (MismatchHash::iterator mit = mismatch_hash[g_type].begin(); mit != mismatch_hash[g_type].end(); mit++)  {
 					insert_mismatch_counts(hash[g_type], mismatch_hash[g_type], mit->first);
                 }
+                hash[g_type].sort_by_key();
             }
         }
         mismatch_hash.clear();
     }
 }
 
-void GraphKernel::normalize_spectral(map<Key,MismatchInfo> &hash, unsigned long g_type)  {
+void GraphKernel::normalize_spectral(MismatchHash &hash, unsigned long g_type)  {
     float norm = sqrt(distance_hash_join(hash, hash, g_type));    
     if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
-		for (map<Key,MismatchInfo>::iterator it = hash.begin(); it != hash.end(); it++)  {
+		for (MismatchHash::iterator it = hash.begin(); it != hash.end(); it++)  {
 			it->second.matches = retrieve_label_mismatch_count(g_type, hash, it->first)/norm;
 		}
 	}
 }
 
-float GraphKernel::distance_hash_join(map<Key,MismatchInfo> g_hash, map<Key,MismatchInfo> h_hash, unsigned long g_type)  {
+float GraphKernel::distance_hash_join(const MismatchHash &g_hash, const MismatchHash &h_hash, unsigned long g_type)  {
     float sum(0);
 	
 	if((g_type == 0 && (GRAPHLETS_1)) || (g_type == 1 && GRAPHLETS_2) || ((g_type >= 2 && g_type <= 4) && GRAPHLETS_3) || ((g_type >= 5 && g_type <= 15) && GRAPHLETS_4) || ((g_type >= 16 && g_type <= 73) && GRAPHLETS_5))  {
-		for (map<Key,MismatchInfo>::iterator git = g_hash.begin(); git != g_hash.end(); git++)  {
-			map<Key,MismatchInfo>::iterator hit = h_hash.find(git->first);
+		for (MismatchHash::const_iterator git = g_hash.begin(); git != g_hash.end(); git++)  {
+			MismatchHash::const_iterator hit = h_hash.find(git->first);
 			if (hit != h_hash.end())  {
 				if (NORMALIZE)  {
 					sum += git->second.matches * hit->second.matches;
                 }
 				else  {                
-					sum += retrieve_label_mismatch_count(g_type, g_hash, git->first) * retrieve_label_mismatch_count(g_type, h_hash, hit->first);
+					sum += label_mismatch_count(git->second) * label_mismatch_count(hit->second);
                 }
 			}
 		}
@@ -2189,28 +2590,28 @@ float GraphKernel::distance_hash_join(map<Key,MismatchInfo> g_hash, map<Key,Mism
     return sum;
 }
 
-void GraphKernel::normalize_spectral(vector<map<Key,MismatchInfo> > &hash)  {
+void GraphKernel::normalize_spectral(vector<MismatchHash> &hash)  {
     float norm = sqrt(distance_hash_join(hash, hash));
     
     for (unsigned i=0; i<GRAPHLET_TYPES; i++)  {
-        for (map<Key,MismatchInfo>::iterator it = hash[i].begin(); it != hash[i].end(); it++)
+        for (MismatchHash::iterator it = hash[i].begin(); it != hash[i].end(); it++)
             it->second.matches = retrieve_edge_mismatch_count(hash[i], it->first)/norm;
     }
 }
 
-float GraphKernel::distance_hash_join(vector<map<Key,MismatchInfo> > g_hash, vector<map<Key,MismatchInfo> > h_hash)  {
+float GraphKernel::distance_hash_join(const vector<MismatchHash> &g_hash, const vector<MismatchHash> &h_hash)  {
     float sum(0);
     
     for (unsigned i=0; i<GRAPHLET_TYPES; i++)  {
         if((i == 0 && (GRAPHLETS_1)) || (i == 1 && GRAPHLETS_2) || ((i >= 2 && i <= 4) && GRAPHLETS_3) || ((i >= 5 && i <= 15) && GRAPHLETS_4) || ((i >= 16 && i <= 73) && GRAPHLETS_5))  {
-            for (map<Key,MismatchInfo>::iterator git = g_hash[i].begin(); git != g_hash[i].end(); git++)  {
-                map<Key,MismatchInfo>::iterator hit = h_hash[i].find(git->first);
+            for (MismatchHash::const_iterator git = g_hash[i].begin(); git != g_hash[i].end(); git++)  {
+                MismatchHash::const_iterator hit = h_hash[i].find(git->first);
             
                 if (hit != h_hash[i].end())  {
                     if (NORMALIZE)
                         sum += git->second.matches * hit->second.matches;
                     else
-                        sum += retrieve_edge_mismatch_count(g_hash[i], git->first) * retrieve_edge_mismatch_count(h_hash[i], hit->first);
+                        sum += edge_mismatch_count(git->second) * edge_mismatch_count(hit->second);
                 }
             }
         }
@@ -18,6 +18,11 @@
 #include "utils.h"
 #include "mismatches.h"
 #include "simgraph.h"
+#include "contact_graph.h"
+#include "feature_vocabulary.h"
+#include "svm_model.h"
+#include "graph_file.h"
+#include "parallel.h"
 #include <fstream>
 #include <utility>
 #include <list>
@@ -26,15 +31,100 @@
 #include <sys/time.h>
 using namespace std;
 
+// Vertex numbering used while counting (set_vertex_order).
+#define ORDER_FILE      0   // As in the input.
+#define ORDER_RCM       1   // Reverse Cuthill-McKee order of the graph.
+#define ORDER_HILBERT   2   // Hilbert curve order of the atoms; contact graphs only.
+
+// Order in which the roots are processed (set_root_order); output stays in input order.
+#define ROOTS_INPUT     0   // As listed.
+#define ROOTS_BFS       1   // Breadth-first (reverse Cuthill-McKee) order of their vertices.
+#define ROOTS_SPATIAL   2   // Hilbert curve order of their atoms; contact graphs only.
+
+#define MAX_TABLE_RESERVE 256   // Most entries reserved in a graphlet table of a root before counting.
+
+
+/** Feature ids and counts of one root, in output order. */
+typedef vector<pair<Key, float> > FeatureVector;
+
+
+/** The vertices of a rooted neighborhood with a bit matrix, as bit rows of the
+ *  same width: one per distinct label, and one for the vertices at distance 2
+ *  from the root. The keys of triangles (case 011) and of 4-paths and 4-cycles
+ *  through a vertex at distance 2 (case 0112) only depend on the labels, so
+ *  count_graphlets_from counts these per label, by ANDing rows and counting
+ *  bits, instead of one occurrence at a time. Keep one per thread. */
+class LabelRows  {
+public:
+    LabelRows() : words(0)  {}
+    ~LabelRows()  {}
+
+    /** Sets up the rows of g, which needs a bit matrix; dist is the distance of every vertex from the root. */
+    void build(const SimpleGraph &g, const vector<unsigned> &dist);
+
+    /** Adds root neighbor v to those passed, the j_ < i_ of case 011. */
+    inline void pass(const SimpleGraph &g, unsigned v)  {
+        unsigned l = label_index(g.nodes[v]);
+        passed[v >> 6] |= 1ULL << (v & 63);
+        if (passed_count[l]++ == 0)
+            passed_labels.push_back(l);
+    }
+
+    /** Counts the triangles and 3-paths of root neighbor i with the neighbors passed. */
+    void add_triangles(GraphletBuffer &graphlets, const SimpleGraph &g, unsigned i) const;
+
+    /** Starts the case 0112 of root neighbor i: selects its neighbors at distance 2. */
+    void select_second(const SimpleGraph &g, unsigned i);
+
+    /** Tallies the selected neighbors adjacent to root neighbor j or not, per
+     *  label; cycles only if they are counted from this side (i_ < j_). */
+    void count_second(const SimpleGraph &g, unsigned j, bool found_ij, bool cycles);
+
+    /** Counts the case 0112 tallied for root neighbor i, labeled a, and clears the tally. */
+    void add_second(GraphletBuffer &graphlets, char a);
+
+private:
+    inline unsigned label_index(char l) const  { return index_of[(unsigned char) l]; }
+
+    inline void tally_add(unsigned t, unsigned count)  {
+        if (tally[t] == 0)
+            tallied.push_back(t);
+        tally[t] += count;
+    }
+
+    size_t words;                            // 64-bit words per row, as in the bit matrix.
+    string labels;                           // Distinct labels, in order of first vertex.
+    vector<int> index_of;                    // Position of every label in labels, or -1.
+    vector<unsigned long long> rows;         // Vertices of every label.
+    vector<unsigned long long> second;       // Vertices at distance 2 from the root.
+    vector<unsigned long long> passed;       // Root neighbors passed.
+    vector<unsigned> passed_count;           // Root neighbors passed, per label.
+    vector<unsigned> passed_labels;          // Labels with passed_count > 0.
+    vector<unsigned long long> second_of;    // Neighbors of i at distance 2, per label.
+    vector<unsigned> second_count;           // Neighbors of i at distance 2, per label.
+    vector<unsigned> second_labels;          // Labels with second_count > 0.
+    vector<unsigned> tally;                  // Case 0112 of i by orbit (13, 11, 12, 6), label of j and label of k.
+    vector<unsigned> tallied;                // Nonzero entries of tally.
+};
+
 
 class GraphKernel  {
 public:
-    GraphKernel() : NORMALIZE(false), VERBOSE(false), SF(0.0), EM(0)  {}
+    GraphKernel() : NORMALIZE(false), VERBOSE(false), SPARSE_CSR(false), SF(0.0), EM(0), THREADS(1), ORDER(ORDER_FILE), ROOT_ORDER(ROOTS_INPUT), vocabulary(NULL), model(NULL)  {}
     ~GraphKernel()  {}
      
-    /** Read an undirected graph, node labels, and list of vertices of interest over input graph. */
+    /** Read an undirected graph, node labels, and list of vertices of interest over input graph. Binary graph files carry their own labels. */
     void read_graphs(string, string, const vector<unsigned> &);
 
+    /** Build the contact graph of atoms labeled by node labels, and read the list of vertices of interest. */
+    void read_contact_graph(const AtomCoordinates &atoms, const string &nlabels, float threshold, const vector<unsigned> &);
+
+    /** Find the contacts of atoms up to the largest of several thresholds, and read the list of vertices of interest. Select a threshold with set_contact_threshold. */
+    void read_contact_distances(const AtomCoordinates &atoms, const string &nlabels, float max_threshold, const vector<unsigned> &);
+
+    /** Use the contact graph of one threshold of those read by read_contact_distances. */
+    void set_contact_threshold(float threshold);
+
     /** Read a probability similarity matrix for each vertex label as means to weight each label substitution. */
     void read_sim_matrix(string filename);
 
@@ -66,6 +156,18 @@ public:
 	*/
     void write_matrix(const char*);
 
+    /** Writes the vectors of counts of write_sparse_svml_* as CSR arrays instead of SVML^light
+     *  text: FILE.indptr.npy, FILE.indices.npy, FILE.data.npy, FILE.labels.npy and FILE.roots.npy. */
+    inline void set_sparse_csr()  { SPARSE_CSR = true; }
+
+    /** Writes sparse features as the dense columns of vocabulary (kept by the caller)
+     *  instead of feature ids. New features get new columns unless it is frozen. */
+    inline void set_feature_vocabulary(FeatureVocabulary *v)  { vocabulary = v; }
+
+    /** Writes the posterior of every root under model (kept by the caller) as a float64
+     *  .npy file instead of its sparse features; the features are scored as they are counted. */
+    inline void set_svm_model(const SvmModel *m)  { model = m; }
+
     /** Writes vector of counts for label substitutions kernel on SVML^light format. */
     void write_sparse_svml_lm(const char*);
 
@@ -78,6 +180,14 @@ public:
     /** Writes vector of counts for edit distance kernel (2-operations) on SVML^light format. */
     void write_sparse_svml_ed2(const char*);
 
+    /** Returns the posterior of every root under the model for label substitutions kernel,
+     *  as write_sparse_svml_lm writes them with a model, without writing a file. */
+    const vector<double> &score_roots_lm();
+
+    /** Writes the posteriors of the residues, reducing those of write_posteriors over every
+     *  run of consecutive examples in the same residue (given to set_contact_policy). */
+    void write_residue_posteriors(const char *file, unsigned reduce);
+
     /** Writes class labels for each example. */
     void write_labels(const char *);
 
@@ -92,58 +202,166 @@ public:
     inline void set_label_mismatches_root_alphabet(string alphabet)  { ALPHABET_ROOT = alphabet; }
 
 	inline void set_number_edges_mismatches(unsigned edges_mismatches)  { EM = edges_mismatches; }
+
+    inline void set_threads(unsigned threads)  { THREADS = threads; }
+
+    /** Renumbers the vertices of the graphs read afterwards (ORDER_*) so that
+     *  neighborhoods occupy nearby memory. Results are still given per root. */
+    inline void set_vertex_order(unsigned order)  { ORDER = order; }
+
+    /** Limits the contacts of the graphs read afterwards (see ContactPolicy).
+     *  residues gives the residue of every vertex, for the sequence separation;
+     *  distance limits only apply to contact graphs built from coordinates. */
+    inline void set_contact_policy(const ContactPolicy &p, const vector<unsigned> &r)  { policy = p; residues = r; }
+
+    /** Processes the roots in the given order (ROOTS_*), so that consecutive
+     *  roots share their neighborhoods in cache and in batched searches. */
+    inline void set_root_order(unsigned order)  { ROOT_ORDER = order; }
+
+    /** Original id of every vertex of the renumbered graph. */
+    inline const vector<unsigned> &get_vertex_order() const  { return vertex_order; }
     
 private:
+    /** Removes the edges of graph that policy excludes; atoms are empty for graphs read from files. */
+    void sparsify_graph(const AtomCoordinates &atoms);
+
+    /** Renumbers the vertices of graph by ORDER and maps the roots to the new numbers. */
+    void renumber_vertices();
+
+    /** Sets root_sequence by ROOT_ORDER for the current graph. */
+    void sequence_roots();
+
+    /** Costs of the roots in the order of root_sequence. */
+    vector<double> sequence_costs(const vector<double> &costs);
+
+    /** Runs task(k) for the k-th root of root_sequence on scheduler, keeping the order unless it is ROOTS_INPUT. */
+    void run_sequenced(WorkStealingScheduler &scheduler, const vector<double> &costs, const function<void(unsigned)> &task);
+
+    /** Counts graphlets around every root into hashes. */
+    void count_root_graphlets(WorkStealingScheduler &scheduler);
+
+    /** Runs the bounded searches around the roots in batches of BFS_BATCH roots consecutive in root_sequence, when most vertices are roots. */
+    void batch_root_searches();
+
+    /** Returns the number of threads to use for each root; heavy roots are split across all threads. */
+    vector<unsigned> split_heavy_roots(const vector<double> &costs);
+
+    /** Returns the estimated cost of counting graphlets around each root (degree-based). */
+    vector<double> root_costs();
+
+    /** Returns the estimated cost of each row of the kernel matrix. */
+    vector<double> row_costs();
+
+    /** Writes the features of all roots as SVML, CSR arrays or posteriors, as set. */
+    void write_features(const char*, FeatureVector (GraphKernel::*)(unsigned));
+
+    /** Writes one SVML line per root, computing the lines on THREADS worker threads. */
+    void write_sparse_svml(const char*, FeatureVector (GraphKernel::*)(unsigned));
+
+    /** Writes the features of all roots as CSR arrays in .npy files named after prefix. */
+    void write_sparse_csr(const char *prefix, FeatureVector (GraphKernel::*)(unsigned));
+
+    /** Computes the posterior of every root under model into posteriors. */
+    void score_roots(FeatureVector (GraphKernel::*)(unsigned));
+
+    /** Writes the posterior of every root under model as a .npy file. */
+    void write_posteriors(const char*, FeatureVector (GraphKernel::*)(unsigned));
+
+    /** Computes the features of every root, in input order. */
+    vector<FeatureVector> all_root_features(FeatureVector (GraphKernel::*)(unsigned));
+
+    /** Computes the features of every root on THREADS worker threads, in root_sequence
+     *  order, and passes them to use(i, features) as soon as they are counted; use runs
+     *  concurrently and may take the features. */
+    void for_each_root_features(FeatureVector (GraphKernel::*)(unsigned), const function<void(unsigned, FeatureVector&)> &use);
+
+    /** Replaces the feature ids of the rows by vocabulary columns, sorted. */
+    void map_feature_columns(vector<FeatureVector> &rows);
+
+    /** Returns the SVML line of the i-th root with the given features. */
+    string svml_line(unsigned i, const FeatureVector &features);
+
+    /** Returns the features of the i-th root for label substitutions kernel. */
+    FeatureVector sparse_features_lm(unsigned i);
+
+    /** Returns the features of the i-th root for edge indels kernel. */
+    FeatureVector sparse_features_em(unsigned i);
+
+    /** Returns the features of the i-th root for edit distance kernel (1-operation). */
+    FeatureVector sparse_features_ed(unsigned i);
+
+    /** Returns the features of the i-th root for edit distance kernel (2-operations). */
+    FeatureVector sparse_features_ed2(unsigned i);
+
 	/** Returns the cumulative random walk kernel between two rooted neighborhoods. */
     float random_walk_cumulative(SimpleGraph &g, unsigned g1_root, unsigned g2_root, int steps, double restart);
 
 	/** Returns the random walk kernel between two rooted neighborhoods. */
     float random_walk(SimpleGraph &g, unsigned g1_root, unsigned g2_root, int steps, double restart);
 
-    /** Returns the counts of nonisomorphic labeled graphlets on a rooted neighborhood. */
-    vector<map<Key,MismatchInfo> > get_graphlets_counts(SimpleGraph &g, unsigned g_root);
+    /** Returns the counts of nonisomorphic labeled graphlets on a rooted neighborhood, splitting the enumeration across threads. */
+    vector<MismatchHash> get_graphlets_counts(SimpleGraph &g, unsigned g_root, unsigned threads = 1);
+
+    /** Counts the labeled graphlets of a rooted neighborhood that go through every stride-th neighbor of the root. */
+    void count_graphlets_from(SimpleGraph &g, unsigned g_root, const vector<unsigned> &dist, unsigned first, unsigned stride, vector<MismatchHash> &hash);
 
     /** Adds the counts for inexact graphlets based on vertex label substitutions. */
-    void add_vertex_label_mismatch_counts(map<Key,MismatchInfo> &hash, map<Key,MismatchInfo> &mismatch_hash, unsigned long g_type, int VLM, bool option);
+    void add_vertex_label_mismatch_counts(MismatchHash &hash, MismatchHash &mismatch_hash, map<Key, list<Key> > &vl_mismatch_neighborhood, unsigned long g_type, int VLM, bool option);
 
     /** Updates the vector of count with inexact graphlets based on vertex and edge label substitutions. */
-    void update_label_mismatch_counts(map<Key,MismatchInfo> &hash, map<Key,MismatchInfo> &mismatch_hash, unsigned long g_type, bool option, int VLM, bool eq);
+    void update_label_mismatch_counts(MismatchHash &hash, MismatchHash &mismatch_hash, unsigned long g_type, bool option, int VLM, bool eq);
 
     /** Adds the counts for inexact graphlets based on edge insertions and deletions. */
-    void add_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash);
+    void add_edge_mismatch_counts(vector<MismatchHash> &hash);
 
     /** Adds the counts for inexact graphlets based on 1-edge insertion and deletion. */
-    void add_1_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash);
+    void add_1_edge_mismatch_counts(vector<MismatchHash> &hash);
 
     /** Adds the counts for inexact graphlets based on 2-edge insertions and deletions. */
-    void add_2_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash);
+    void add_2_edge_mismatch_counts(vector<MismatchHash> &hash);
 
     /** Normalizes the kernel matrix using the method for normalizing the spectral kernel matrix. */
-    void normalize_spectral(map<Key,MismatchInfo> &, unsigned long g_type);
+    void normalize_spectral(MismatchHash &, unsigned long g_type);
 
     /** Computes graphlet distance between two vector of graphlet counts.*/
-    float distance_hash_join(map<Key,MismatchInfo>, map<Key,MismatchInfo>, unsigned long g_type);
+    float distance_hash_join(const MismatchHash&, const MismatchHash&, unsigned long g_type);
 
     /** Normalizes the kernel matrix using the method for normalizing the spectral kernel matrix. */
-    void normalize_spectral(vector<map<Key,MismatchInfo> >&);
+    void normalize_spectral(vector<MismatchHash>&);
 
     /** Computes graphlet distance between two vector of graphlet counts. */
-    float distance_hash_join(vector<map<Key,MismatchInfo> >, vector<map<Key,MismatchInfo> >);
+    float distance_hash_join(const vector<MismatchHash>&, const vector<MismatchHash>&);
 
     // Data members.
-    bool NORMALIZE, VERBOSE;
+    bool NORMALIZE, VERBOSE, SPARSE_CSR;
     float SF;
 	unsigned EM;
+    unsigned THREADS;
+    unsigned ORDER;
+    unsigned ROOT_ORDER;
     string ALPHABET;
     string ALPHABET_ROOT;
 
     vector<int> labels;
+    FeatureVocabulary  *vocabulary;        // Columns of the sparse features, if set.
+    const SvmModel      *model;            // Scores the sparse features into posteriors, if set.
     SimpleGraph graph;
+    ContactDistances contacts;       // Contacts of every threshold, if read by read_contact_distances.
+    ContactPolicy       policy;            // Limits on the contacts kept in graph.
+    vector<unsigned>    residues;          // Residue of every input vertex, for policy and write_residue_posteriors.
+    AtomCoordinates     contact_atoms;     // Atoms of contacts, if policy limits them by distance.
     vector<unsigned>    roots;       // Vertices of interest.
+    vector<unsigned>    input_roots;       // Vertices of interest as numbered in the input, if renumbered.
+    vector<unsigned>    vertex_order;      // Renumbered vertex -> input vertex, unless ORDER_FILE.
+    vector<unsigned>    atom_order;        // Input vertices in Hilbert curve order of their atoms, if needed.
+    vector<unsigned>    root_sequence;     // Indices of the roots in processing order.
+    vector<unsigned>    root_threads;      // Threads used to count graphlets around each root.
+    vector<MultiSourceBfs> root_batches;   // Searches around roots root_sequence[i*BFS_BATCH .. (i+1)*BFS_BATCH-1].
+    vector<unsigned>    root_batch_slot;   // Vertex -> position of its first occurrence in root_sequence, if batched.
     map<string,float>   sim_vlm_matrix;    
-    vector<vector<map<Key,MismatchInfo> > > hashes;
+    vector<double>      posteriors;        // Posterior of every root, after write_posteriors.
+    vector<vector<MismatchHash> > hashes;
     vector<vector<float> >  kernel;
-    map<Key, list<Key> >    vl_mismatch_neighborhood;
 };
 
 #endif
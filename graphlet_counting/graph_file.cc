@@ -0,0 +1,113 @@
+#include "graph_file.h"
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+
+static const char GRAPH_FILE_MAGIC[8] = { 'G', 'K', 'G', 'R', 'A', 'P', 'H', 0 };
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+static inline uint64_t padded(uint64_t bytes)  {
+    return (bytes + 7) & ~(uint64_t) 7;
+}
+
+
+// Only regular files are sniffed: reading the magic from a pipe would consume
+// it before the text reader gets there.
+bool GraphFile::is_graph_file(const char *file)  {
+    struct stat st;
+    if (stat(file, &st) != 0 || !S_ISREG(st.st_mode))
+        return false;
+
+    char magic[sizeof(GRAPH_FILE_MAGIC)];
+    ifstream in(file, ios::in | ios::binary);
+    return in.read(magic, sizeof(magic)) && memcmp(magic, GRAPH_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+
+void GraphFile::open(const char *graph_file)  {
+    if (!file.open(graph_file))  {
+        cerr << "ERROR: Graph file " << graph_file << " could not be opened." << endl; exit(1);
+    }
+
+    header = (const GraphFileHeader*) file.begin();
+    if (file.size() < sizeof(GraphFileHeader) || memcmp(header->magic, GRAPH_FILE_MAGIC, sizeof(GRAPH_FILE_MAGIC)) != 0)  {
+        cerr << "ERROR: " << graph_file << " is not a binary graph file." << endl; exit(1);
+    }
+    if (header->version != GRAPH_FILE_VERSION || header->byte_order != BYTE_ORDER_MARK)  {
+        cerr << "ERROR: Binary graph file " << graph_file << " has version " << header->version << " or byte order of another machine; convert it again." << endl; exit(1);
+    }
+
+    uint64_t n = header->vertices, m = header->entries;
+    uint64_t expected = sizeof(GraphFileHeader) + padded(n) + 8 * (n + 1) + 4 * m;
+    if (n >= UINT_MAX || m > (file.size() / 4) || file.size() != expected)  {
+        cerr << "ERROR: Binary graph file " << graph_file << " is truncated or corrupt." << endl; exit(1);
+    }
+    row_offsets = (const uint64_t*) (file.begin() + sizeof(GraphFileHeader) + padded(n));
+    row_neighbors = (const uint32_t*) (row_offsets + n + 1);
+
+    if (row_offsets[0] != 0 || row_offsets[n] != m)  {
+        cerr << "ERROR: Binary graph file " << graph_file << " is truncated or corrupt." << endl; exit(1);
+    }
+    for (uint64_t i=0; i<n; i++)  {
+        if (row_offsets[i] > row_offsets[i+1])  {
+            cerr << "ERROR: Row " << i << " of binary graph file " << graph_file << " ends before it starts." << endl; exit(1);
+        }
+    }
+    for (uint64_t e=0; e<m; e++)  {
+        if (row_neighbors[e] >= n)  {
+            cerr << "ERROR: Node index " << row_neighbors[e] << " >= graph size " << n << " in graph file " << graph_file << "." << endl; exit(1);
+        }
+    }
+}
+
+
+SimpleGraph read_graph_file(const char *file)  {
+    GraphFile view;
+    view.open(file);
+
+    SimpleGraph g;
+    unsigned n = view.size();
+    g.nodes.assign(view.labels(), n);
+    g.adj.resize(n);
+    for (unsigned i=0; i<n; i++)
+        g.adj[i].assign(view.neighbors() + view.offsets()[i], view.neighbors() + view.offsets()[i+1]);
+
+    g.index_edges();
+    return g;
+}
+
+
+void write_graph_file(const char *file, const SimpleGraph &g)  {
+    ofstream out(file, ios::out | ios::binary);
+    if (out.fail())  {
+        cerr << "ERROR: Graph file " << file << " could not be created." << endl; exit(1);
+    }
+
+    uint64_t n = g.adj.size();
+    vector<uint64_t> offsets(n + 1, 0);
+    for (uint64_t i=0; i<n; i++)
+        offsets[i+1] = offsets[i] + g.adj[i].size();
+
+    GraphFileHeader header;
+    memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(GRAPH_FILE_MAGIC));
+    header.version = GRAPH_FILE_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.vertices = n;
+    header.entries = offsets[n];
+    out.write((const char*) &header, sizeof(header));
+
+    string labels(g.nodes);
+    labels.resize(padded(n), 0);
+    out.write(labels.data(), labels.size());
+    out.write((const char*) offsets.data(), 8 * (n + 1));
+    for (uint64_t i=0; i<n; i++)  {
+        vector<uint32_t> row(g.adj[i].begin(), g.adj[i].end());
+        out.write((const char*) row.data(), 4 * row.size());
+    }
+
+    out.close();
+    if (out.fail())  {
+        cerr << "ERROR: Graph file " << file << " could not be written." << endl; exit(1);
+    }
+}
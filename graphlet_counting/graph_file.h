@@ -0,0 +1,74 @@
+/**
+ * Binary graph files: vertex labels and adjacency lists in CSR form.
+ *
+ * Layout (native little-endian integers, every array 8-byte aligned):
+ *
+ *   offset 0   char[8]   magic "GKGRAPH\0"
+ *   offset 8   uint32    version (GRAPH_FILE_VERSION)
+ *   offset 12  uint32    byte order mark 0x01020304
+ *   offset 16  uint64    n, number of vertices
+ *   offset 24  uint64    m, number of adjacency entries (twice the edges)
+ *   offset 32  char[n]   vertex labels, zero-padded to a multiple of 8
+ *              uint64[n+1]  row offsets, offsets[0] = 0, offsets[n] = m
+ *              uint32[m]    neighbors; row i is neighbors[offsets[i]] .. [offsets[i+1]-1]
+ *
+ * Rows hold the adjacency lists exactly as SimpleGraph::read_graph builds
+ * them from a text .graph file (duplicates removed, file order), so a graph
+ * loaded from either file counts the same graphlets. The file is mapped
+ * and validated in one pass; GraphFile gives the arrays in place.
+ *
+ */
+
+#ifndef __GRAPH_FILE_H__
+#define __GRAPH_FILE_H__
+
+#define GRAPH_FILE_VERSION 1
+
+#include "mapped_file.h"
+#include "simgraph.h"
+#include <stdint.h>
+using namespace std;
+
+
+/** Header of a binary graph file. */
+struct GraphFileHeader  {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t vertices;
+    uint64_t entries;
+};
+
+
+/** Read-only view of a mapped binary graph file. */
+class GraphFile  {
+public:
+    GraphFile() : header(NULL), row_offsets(NULL), row_neighbors(NULL)  {}
+
+    /** Returns true if file is a regular file that starts with the magic of a
+     *  binary graph file. Pipes and FIFOs are always read as text. */
+    static bool is_graph_file(const char *file);
+
+    /** Maps and validates file; exits with an error if it is not a valid graph file. */
+    void open(const char *file);
+
+    inline size_t size() const  { return header->vertices; }
+    inline const char *labels() const  { return (const char*) (header + 1); }
+    inline const uint64_t *offsets() const  { return row_offsets; }
+    inline const uint32_t *neighbors() const  { return row_neighbors; }
+
+private:
+    MappedFile file;
+    const GraphFileHeader *header;
+    const uint64_t *row_offsets;
+    const uint32_t *row_neighbors;
+};
+
+
+/** Loads a graph from a binary graph file. */
+SimpleGraph read_graph_file(const char *file);
+
+/** Writes a graph (labels and adjacency lists) as a binary graph file. */
+void write_graph_file(const char *file, const SimpleGraph &g);
+
+#endif
@@ -0,0 +1,82 @@
+#include "mapped_file.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// Empty files cannot be mapped; they are read as an empty range.
+static const char EMPTY[1] = { 0 };
+
+// Reads fd to the end into buffer, for pipes and FIFOs (whose st_size is 0).
+static bool read_all(int fd, vector<char> &buffer)  {
+    size_t used = 0;
+    buffer.resize(1 << 16);
+    for (;;)  {
+        if (used == buffer.size())
+            buffer.resize(2 * buffer.size());
+        ssize_t got = read(fd, &buffer[used], buffer.size() - used);
+        if (got == 0)
+            break;
+        if (got < 0)  {
+            if (errno == EINTR)
+                continue;
+            buffer.clear();
+            return false;
+        }
+        used += got;
+    }
+    buffer.resize(used);
+    return true;
+}
+
+bool MappedFile::open(const char *file)  {
+    close();
+
+    int fd = ::open(file, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)  {
+        ::close(fd);
+        return false;
+    }
+
+    if (!S_ISREG(st.st_mode))  {
+        bool ok = read_all(fd, buffer);
+        ::close(fd);
+        if (!ok)
+            return false;
+        length = buffer.size();
+        data = length > 0 ? &buffer[0] : EMPTY;
+        return true;
+    }
+
+    length = st.st_size;
+    if (length == 0)  {
+        data = EMPTY;
+        ::close(fd);
+        return true;
+    }
+
+    void *map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)  {
+        length = 0;
+        return false;
+    }
+    madvise(map, length, MADV_SEQUENTIAL);
+    data = (const char*) map;
+    return true;
+}
+
+
+void MappedFile::close()  {
+    if (data != NULL && data != EMPTY && buffer.empty())
+        munmap((void*) data, length);
+    vector<char>().swap(buffer);
+    data = NULL;
+    length = 0;
+}
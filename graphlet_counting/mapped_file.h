@@ -0,0 +1,44 @@
+/**
+ * Read-only memory map of a whole file.
+ *
+ * Readers scan the mapped bytes in place instead of copying them through
+ * stream buffers and per-line strings, and the kernel pages the file in
+ * on demand. Pipes, FIFOs and other files that cannot be mapped are read
+ * into an owned buffer instead.
+ *
+ */
+
+#ifndef __MAPPED_FILE_H__
+#define __MAPPED_FILE_H__
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+
+class MappedFile  {
+public:
+    MappedFile() : data(NULL), length(0)  {}
+    ~MappedFile()  { close(); }
+
+    /** Maps file, or reads it whole if it is not a regular file; returns false
+     *  if it cannot be opened, mapped or read. */
+    bool open(const char *file);
+
+    /** Unmaps the file. */
+    void close();
+
+    inline const char *begin() const  { return data; }
+    inline const char *end() const  { return data + length; }
+    inline size_t size() const  { return length; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile &operator=(const MappedFile&);
+
+    const char *data;
+    size_t length;
+    vector<char> buffer;    // Contents of a file that was read rather than mapped.
+};
+
+#endif
@@ -15,6 +15,8 @@
 #define	MISMATCHES_H
 
 #include "utils.h"
+#include "flat_hash.h"
+#include "canonical.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -32,19 +34,84 @@ void initialize_vertices_labels(Key key, char &root, char &a, char &b, char &c,
 
 Key get_feature_id(Key k, unsigned long g_type);
 
-void increment_match_hash(map<Key,MismatchInfo> &hash, const Key &k, vector<Key> &mismatches_list);
-
-float retrieve_exact_matches_count(map<Key,MismatchInfo> &hash, const Key &k);
-
-float retrieve_edge_mismatch_count(map<Key,MismatchInfo> &hash, const Key &k);
-
-float retrieve_label_mismatch_count(unsigned long orbit, map<Key,MismatchInfo> &hash, const Key key);
-
-void insert_mismatch_counts(map<Key,MismatchInfo> &hash, map<Key,MismatchInfo> &mismatch_hash, const Key &k);
-
-void insert_mismatches_hash(map<Key,MismatchInfo> &mismatch_hash, const Key &k, vector<Key> mismatches_list);
-
-Key create_permutations_subset(vector<Key> &mismatches, char root, char a, char b, char c, char d, unsigned long orbit);
+void increment_match_hash(MismatchHash &hash, const Key &k, float count = 1.0);
+
+/** Labelings of a LabelBatch with the number of occurrences of each. */
+struct CountedBatch  {
+    LabelBatch labels;
+    unsigned count[LABEL_BATCH];
+};
+
+/** Collects the graphlets found around one root per orbit and canonicalizes
+ *  them LABEL_BATCH at a time before counting them into hash. */
+class GraphletBuffer  {
+public:
+    GraphletBuffer(char root, vector<MismatchHash> &hash) : root(root), hash(hash), batches(GRAPHLET_TYPES), counted(GRAPHLET_TYPES)  {}
+    ~GraphletBuffer()  {}
+
+    /** Adds one occurrence of orbit g_type with non-root labels a,b,c,d (in orbit order). */
+    inline void add(unsigned long g_type, char a, char b, char c, char d)  {
+        LabelBatch &batch = batches[g_type];
+        batch.column[0][batch.size] = a;
+        batch.column[1][batch.size] = b;
+        batch.column[2][batch.size] = c;
+        batch.column[3][batch.size] = d;
+        if (++batch.size == LABEL_BATCH)
+            flush(g_type);
+    }
+
+    /** Adds count occurrences of orbit g_type with non-root labels a,b,c,d at once. */
+    inline void add(unsigned long g_type, char a, char b, char c, char d, unsigned count)  {
+        if (count == 0)
+            return;
+        CountedBatch &batch = counted[g_type];
+        LabelBatch &labels = batch.labels;
+        labels.column[0][labels.size] = a;
+        labels.column[1][labels.size] = b;
+        labels.column[2][labels.size] = c;
+        labels.column[3][labels.size] = d;
+        batch.count[labels.size] = count;
+        if (++labels.size == LABEL_BATCH)
+            flush_counted(g_type);
+    }
+
+    /** Counts all buffered graphlets. Must be called before hash is read. */
+    void flush();
+
+private:
+    void flush(unsigned long g_type);
+    void flush_counted(unsigned long g_type);
+
+    char root;
+    vector<MismatchHash> &hash;
+    vector<LabelBatch> batches;
+    vector<CountedBatch> counted;
+};
+
+/** Exact matches plus edge mismatches of one graphlet. */
+float edge_mismatch_count(const MismatchInfo &info);
+
+/** Exact matches plus edge and vertex label mismatches of one graphlet. */
+float label_mismatch_count(const MismatchInfo &info);
+
+float retrieve_exact_matches_count(MismatchHash &hash, const Key &k);
+
+float retrieve_edge_mismatch_count(MismatchHash &hash, const Key &k);
+
+float retrieve_label_mismatch_count(unsigned long orbit, MismatchHash &hash, const Key key);
+
+void insert_mismatch_counts(MismatchHash &hash, MismatchHash &mismatch_hash, const Key &k);
+
+void insert_mismatches_hash(MismatchHash &mismatch_hash, const Key &k);
+
+/** Attaches the (zero) label permutation counts to the graphlets of hash that do not have them yet. */
+void add_permutation_subsets(MismatchHash &hash, unsigned long g_type);
+
+/** Canonical key of a graphlet of the given orbit (the fast path used while counting). */
+Key canonical_key(char root, char a, char b, char c, char d, unsigned long orbit);
+
+/** Allowed label permutations of a canonical key, the key itself first. */
+void create_permutations_subset(vector<Key> &mismatches, Key k, unsigned long orbit);
 
 void insert_graphlet_mismatch_neighborhood(list<Key> &neighborhood, Key k);
 
@@ -52,15 +119,15 @@ void generate_graphlet_mismatch_neighborhood_m1(list<Key> &neighborhood, string
 
 void generate_graphlet_mismatch_neighborhood_m2(list<Key> &neighborhood, string ALPHABET_ROOT, string ALPHABET, map<string, float> &sim_matrix, unsigned long orbit, Key key);
 
-void generate_vertex_label_mismatch_graphlets(map<Key, list<Key> > &vl_mismatch_neighborhood, map<Key,MismatchInfo> &hash, map<Key,MismatchInfo> &mismatch_hash, Key key, unsigned long orbit, string ALPHABET_ROOT, string ALPHABET, map<string, float> &sim_matrix, int VLM);
+void generate_vertex_label_mismatch_graphlets(map<Key, list<Key> > &vl_mismatch_neighborhood, MismatchHash &hash, MismatchHash &mismatch_hash, Key key, unsigned long orbit, string ALPHABET_ROOT, string ALPHABET, map<string, float> &sim_matrix, int VLM);
 
-void increment_mismatch_count(map<Key,MismatchInfo> &hash, const Key &key, const Key &mismatch_key, float sim_score, float mult_factor);
+void increment_mismatch_count(MismatchHash &hash, const Key &key, const Key &mismatch_key, float sim_score, float mult_factor);
 
 float compare_graphlets(Key key1, Key key2, unsigned long orbit, map<string, float> &sim_matrix, float &sim_score);
 
-void update_mismatch_count(map<Key,MismatchInfo> &hash, Key k, float mult_factor, unsigned long orbit, map<string, float> sim_matrix, int VLM, bool eq);
+void update_mismatch_count(MismatchHash &hash, Key k, float mult_factor, unsigned long orbit, map<string, float> sim_matrix, int VLM, bool eq);
 
-void increment_edge_mismatch_hash(map<Key,MismatchInfo> &hash, map<Key,MismatchInfo> &mismatch_hash, const Key &k, float mult_factor, vector<Key> &mismatches_list);
+void increment_edge_mismatch_hash(MismatchHash &hash, MismatchHash &mismatch_hash, const Key &k, float mult_factor);
 
 void insert_edge_mismatch_graphlet(list<pair <unsigned long, Key> > &EM_set, pair <unsigned long, Key> graphlet, unsigned index);
 
@@ -0,0 +1,153 @@
+/**
+ * Predicts catalytic residue posteriors from a structure file in one process,
+ * as ncac_cat_pipeline.py does: backbone N, CA and C atoms, contact graph,
+ * standard graphlet counts around every atom, calibrated linear SVM, and the
+ * mean posterior of every residue. Nothing is written but the output.
+ *
+ * Usage: ncac_predict -P PDB -m MODEL -o OUTPUT [-y ATOMS] [-a REDUCE] [-d DIST]
+ *                     [-K NEAREST] [-D MAXDEG] [-Q MINSEP] [-O ORDER] [-r ROOTS] [-j THREADS]
+ *
+ * The time of every stage is printed on standard error.
+ *
+ */
+
+#include "backbone.h"
+#include "contact_graph.h"
+#include "gkernel.h"
+#include "npy_file.h"
+#include "string.h"
+#include "svm_model.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+
+void print_help()  {
+    cout << "Usage: ncac_predict -P PDB -m MODEL -o OUTPUT [-y ATOMS] [-a REDUCE] [-d DIST]\n";
+    cout << "                    [-K NEAREST] [-D MAXDEG] [-Q MINSEP] [-O ORDER] [-r ROOTS] [-j THREADS]\n";
+    cout << "Options:\n\n";
+
+    cout << "  -h         Displays this message.\n\n";
+
+    cout << "  -P PDB     Structure file (PDB, or mmCIF if named .cif). Every N, CA and C atom of chain A is scored.\n";
+    cout << "  -m MODEL   Calibrated linear SVM, written by export_svm_model.py.\n";
+    cout << "  -o OUTPUT  Output file for the posterior of every residue (float64 NumPy file).\n";
+    cout << "  -y ATOMS   Output file for the posterior of every atom (float64 NumPy file).\n\n";
+
+    cout << "  -a REDUCE  Reduction of the posteriors of the atoms of a residue (0-Mean, 1-Maximum, 2-Noisy-OR).\n";
+    cout << "             Defaults to 0, as the pipeline.\n\n";
+
+    cout << "  -d DIST    Contact distance.\n";
+    cout << "             Defaults to 7.5.\n\n";
+
+    cout << "  -K NEAREST Keep only contacts among the NEAREST closest of either atom.\n";
+    cout << "  -D MAXDEG  Keep contacts shortest first while both atoms have fewer than MAXDEG.\n";
+    cout << "  -Q MINSEP  Drop contacts between residues fewer than MINSEP apart in sequence, except backbone bonds.\n";
+    cout << "             The model should be trained on graphs with the same limits. Defaults to 0 (no limit).\n\n";
+
+    cout << "  -O ORDER   Vertex numbering while counting (0-Input order, 1-Reverse Cuthill-McKee, 2-Hilbert curve).\n";
+    cout << "  -r ROOTS   Order in which the atoms are processed (0-Chain order, 1-Breadth-first, 2-Hilbert curve).\n";
+    cout << "             Outputs are the same for every order. Defaults to 0.\n\n";
+
+    cout << "  -j THREADS Number of threads used to count graphlets (0 uses all hardware threads).\n";
+    cout << "             Defaults to 1.\n\n";
+}
+
+static double elapsed(chrono::steady_clock::time_point start)  {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char *stage, double seconds)  {
+    cerr << "  " << stage << ": " << seconds << " s" << endl;
+}
+
+int main(int argc, char *argv[])  {
+    string structure_file, model_file, output_file, atoms_file;
+    float contact_distance(CONTACT_THRESHOLD);
+    ContactPolicy policy;
+    unsigned reduce(REDUCE_MEAN);
+    unsigned order(ORDER_FILE);
+    unsigned root_order(ROOTS_INPUT);
+    unsigned threads(1);
+
+    for (int i=1; i<argc; i++)  {
+        if (argv[i][0] != '-' || strlen(argv[i]) != 2 || (argv[i][1] != 'h' && i+1 >= argc))  {
+            cerr << "ERROR: Unknown option " << argv[i] << endl;
+            print_help();  exit(1);
+        }
+        switch (argv[i][1])  {
+            case 'h': print_help(); exit(0);
+            case 'P': structure_file = argv[++i]; break;
+            case 'm': model_file = argv[++i]; break;
+            case 'o': output_file = argv[++i]; break;
+            case 'y': atoms_file = argv[++i]; break;
+            case 'a': reduce = to_i(argv[++i]); break;
+            case 'd': contact_distance = to_f(argv[++i]); break;
+            case 'K': policy.nearest = to_i(argv[++i]); break;
+            case 'D': policy.max_degree = to_i(argv[++i]); break;
+            case 'Q': policy.min_separation = to_i(argv[++i]); break;
+            case 'O': order = to_i(argv[++i]); break;
+            case 'r': root_order = to_i(argv[++i]); break;
+            case 'j': threads = to_i(argv[++i]); break;
+            default:
+                cerr << "ERROR: Unknown option " << argv[i] << endl;
+                print_help();  exit(1);
+        }
+    }
+
+    if (0 == structure_file.size() || 0 == model_file.size() || 0 == output_file.size())  {
+        cerr << "ERROR: Structure (-P), model (-m) and output (-o) files are required." << endl;  print_help();  exit(1);
+    }
+    if (reduce > REDUCE_NOISY_OR || order > ORDER_HILBERT || root_order > ROOTS_SPATIAL)  {
+        cerr << "ERROR: Unknown reduction (-a), vertex order (-O) or root order (-r)." << endl;  print_help();  exit(1);
+    }
+
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now(), start = begin;
+    cerr << "Predicting " << structure_file << endl;
+
+    SvmModel model;
+    model.open(model_file.c_str());
+    report("model", elapsed(start));
+
+    start = chrono::steady_clock::now();
+    Backbone backbone = read_backbone(structure_file.c_str());
+    if (backbone.atoms.size() == 0)  {
+        cerr << "ERROR: No backbone atoms in chain A of " << structure_file << "." << endl; exit(1);
+    }
+    report("parse", elapsed(start));
+
+    // Every atom is an example, as in the .atom_pos file of the pipeline.
+    start = chrono::steady_clock::now();
+    GraphKernel gk;
+    vector<unsigned> examples(backbone.atoms.size());
+    for (unsigned v=0; v<examples.size(); v++)
+        examples[v] = v;
+    gk.set_threads(threads);
+    gk.set_vertex_order(order);
+    gk.set_root_order(root_order);
+    gk.set_contact_policy(policy, backbone.residue_indices);
+    gk.read_contact_graph(backbone.atoms, backbone.labels, contact_distance, examples);
+    gk.set_labels(vector<int>(examples.size(), 1));
+    report("contact graph", elapsed(start));
+
+    // Roots are scored as they are counted, so the two stages are timed together.
+    start = chrono::steady_clock::now();
+    gk.set_number_label_mismatches(0.0);
+    gk.set_svm_model(&model);
+    const vector<double> &posteriors = gk.score_roots_lm();
+    report("counting and scoring", elapsed(start));
+
+    start = chrono::steady_clock::now();
+    vector<double> residues = residue_posteriors(posteriors, backbone.residue_indices, reduce);
+    report("aggregation", elapsed(start));
+
+    start = chrono::steady_clock::now();
+    write_npy(output_file, residues);
+    if (atoms_file.size() > 0)
+        write_npy(atoms_file, posteriors);
+    report("output", elapsed(start));
+
+    cerr << "  total: " << elapsed(begin) << " s (" << examples.size() << " atoms, " << residues.size() << " residues)" << endl;
+    exit(0);
+}
@@ -0,0 +1,34 @@
+#include "npy_file.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+// Header: magic, version 1.0, little-endian length of the dict, then the dict
+// padded with spaces and a newline so that the data starts 64-byte aligned.
+void write_npy(const string &file, const char *descr, const void *data, size_t length, size_t item_size)  {
+    ofstream out(file.c_str(), ios::out | ios::binary);
+    if (out.fail())  {
+        cerr << "ERROR: Array file " << file << " could not be created." << endl; exit(1);
+    }
+
+    ostringstream dict;
+    dict << "{'descr': '" << descr << "', 'fortran_order': False, 'shape': (" << length << ",), }";
+    string header = dict.str();
+    size_t total = 10 + header.size() + 1;
+    header.append((64 - total % 64) % 64, ' ');
+    header += '\n';
+
+    uint16_t header_length = header.size();
+    out.write("\x93NUMPY\x01\x00", 8);
+    out.put(header_length & 0xff);
+    out.put(header_length >> 8);
+    out.write(header.data(), header.size());
+    out.write((const char*) data, length * item_size);
+
+    out.close();
+    if (out.fail())  {
+        cerr << "ERROR: Array file " << file << " could not be written." << endl; exit(1);
+    }
+}
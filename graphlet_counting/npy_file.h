@@ -0,0 +1,28 @@
+/**
+ * One-dimensional NumPy .npy files (format version 1.0).
+ *
+ * Arrays are written as a header followed by the raw little-endian values,
+ * so Python reads them with np.load(file, mmap_mode='r') without parsing
+ * or copying.
+ *
+ */
+
+#ifndef __NPY_FILE_H__
+#define __NPY_FILE_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+using namespace std;
+
+
+/** Writes length values of item_size bytes each as a 1-D array of NumPy type descr (e.g. "<f4"). */
+void write_npy(const string &file, const char *descr, const void *data, size_t length, size_t item_size);
+
+inline void write_npy(const string &file, const vector<int32_t> &v)  { write_npy(file, "<i4", v.data(), v.size(), 4); }
+inline void write_npy(const string &file, const vector<uint32_t> &v)  { write_npy(file, "<u4", v.data(), v.size(), 4); }
+inline void write_npy(const string &file, const vector<int64_t> &v)  { write_npy(file, "<i8", v.data(), v.size(), 8); }
+inline void write_npy(const string &file, const vector<float> &v)  { write_npy(file, "<f4", v.data(), v.size(), 4); }
+inline void write_npy(const string &file, const vector<double> &v)  { write_npy(file, "<f8", v.data(), v.size(), 8); }
+
+#endif
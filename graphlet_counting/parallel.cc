@@ -0,0 +1,102 @@
+#include "parallel.h"
+#include <algorithm>
+
+
+unsigned resolve_threads(unsigned threads)  {
+    if (threads == 0)  {
+        threads = thread::hardware_concurrency();
+        if (threads == 0)
+            threads = 1;
+    }
+    return threads;
+}
+
+
+void WorkStealingScheduler::run(const vector<double> &costs, const function<void(unsigned)> &task)  {
+    unsigned n = costs.size();
+    unsigned workers = min(THREADS, n);
+
+    if (workers <= 1)  {
+        for (unsigned i=0; i<n; i++)
+            task(i);
+        return;
+    }
+
+    // Deal tasks round-robin in decreasing order of cost, so that every
+    // worker starts with a similar share of the heavy tasks.
+    vector<unsigned> order(n);
+    for (unsigned i=0; i<n; i++)
+        order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b)  { return costs[a] > costs[b]; });
+
+    queues.assign(workers, deque<unsigned>());
+    for (unsigned k=0; k<n; k++)
+        queues[k % workers].push_back(order[k]);
+    run_queues(workers, task);
+}
+
+void WorkStealingScheduler::run_in_order(const vector<double> &costs, const function<void(unsigned)> &task)  {
+    unsigned n = costs.size();
+    unsigned workers = min(THREADS, n);
+
+    if (workers <= 1)  {
+        for (unsigned i=0; i<n; i++)
+            task(i);
+        return;
+    }
+
+    // Cut [0,n) where the running cost passes each worker's share. Without
+    // costs, the slices have the same number of tasks.
+    double total = 0.0;
+    for (unsigned i=0; i<n; i++)
+        total += costs[i];
+
+    queues.assign(workers, deque<unsigned>());
+    double before = 0.0;
+    for (unsigned i=0; i<n; i++)  {
+        double position = total > 0.0 ? (before + costs[i] / 2) / total : (i + 0.5) / n;
+        queues[min<unsigned>(position * workers, workers - 1)].push_back(i);
+        before += costs[i];
+    }
+    run_queues(workers, task);
+}
+
+void WorkStealingScheduler::run_queues(unsigned workers, const function<void(unsigned)> &task)  {
+    vector<mutex>(workers).swap(locks);
+    vector<thread> pool;
+    for (unsigned w=0; w<workers; w++)  {
+        pool.push_back(thread([&, w]()  {
+            unsigned i;
+            while (next_task(w, i))
+                task(i);
+        }));
+    }
+    for (unsigned w=0; w<workers; w++)
+        pool[w].join();
+
+    queues.clear();
+}
+
+bool WorkStealingScheduler::next_task(unsigned w, unsigned &i)  {
+    {
+        lock_guard<mutex> lock(locks[w]);
+        if (!queues[w].empty())  {
+            i = queues[w].front();
+            queues[w].pop_front();
+            return true;
+        }
+    }
+
+    // Own deque is empty; steal the last task of another worker: the cheapest
+    // one, or the end of its slice in run_in_order.
+    for (unsigned k=1; k<queues.size(); k++)  {
+        unsigned victim = (w + k) % queues.size();
+        lock_guard<mutex> lock(locks[victim]);
+        if (!queues[victim].empty())  {
+            i = queues[victim].back();
+            queues[victim].pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,108 @@
+/**
+ * Thread helpers for processing vertices of interest (roots) in parallel.
+ *
+ * Roots are independent of each other, but the cost of counting graphlets
+ * around a root grows quickly with its degree, so tasks are scheduled by
+ * estimated cost on a work-stealing pool, or in contiguous slices when the
+ * order of the roots matters for locality. Results that have to be written
+ * in order (e.g. SVML lines) are consumed on the calling thread in root
+ * order.
+ *
+ */
+
+#ifndef __PARALLEL_H__
+#define __PARALLEL_H__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+
+/** Resolves the number of worker threads (0 means one per hardware thread). */
+unsigned resolve_threads(unsigned threads);
+
+
+/** Work-stealing scheduler for independent tasks with skewed costs. Tasks are
+ *  dealt to per-worker deques in decreasing order of estimated cost. Each
+ *  worker runs its own tasks heaviest first and, once its deque is empty,
+ *  steals the lightest remaining task from another worker. run_in_order
+ *  keeps the order of the tasks instead. */
+class WorkStealingScheduler  {
+public:
+    WorkStealingScheduler(unsigned threads) : THREADS(resolve_threads(threads))  {}
+    ~WorkStealingScheduler()  {}
+
+    /** Runs task(i) for every i in [0,costs.size()) and returns when all tasks are done. */
+    void run(const vector<double> &costs, const function<void(unsigned)> &task);
+
+    /** Same as run, for tasks whose neighbors share data: every worker gets a
+     *  contiguous slice of [0,costs.size()) of about equal cost and runs it in
+     *  increasing order; an idle worker steals from the end of another slice. */
+    void run_in_order(const vector<double> &costs, const function<void(unsigned)> &task);
+
+    inline unsigned threads() const  { return THREADS; }
+
+private:
+    /** Runs the dealt queues on workers threads until all tasks are done. */
+    void run_queues(unsigned workers, const function<void(unsigned)> &task);
+
+    /** Takes the next task for worker w, stealing if needed. Returns false when no tasks are left. */
+    bool next_task(unsigned w, unsigned &i);
+
+    unsigned THREADS;
+    vector<deque<unsigned> > queues;
+    vector<mutex> locks;
+};
+
+
+/** Computes task(i) for every i in [0,costs.size()) on a work-stealing pool and
+ *  passes each result to sink(i, result) on the calling thread in increasing
+ *  order of i. With a single thread everything runs on the calling thread. */
+template <class Task, class Sink>
+void ordered_parallel_for(const vector<double> &costs, unsigned threads, Task task, Sink sink)  {
+    unsigned n = costs.size();
+    threads = resolve_threads(threads);
+
+    if (threads <= 1 || n <= 1)  {
+        for (unsigned i=0; i<n; i++)
+            sink(i, task(i));
+        return;
+    }
+
+    vector<string> results(n);
+    vector<char> ready(n, 0);
+    mutex m;
+    condition_variable cv;
+
+    WorkStealingScheduler scheduler(threads);
+    thread pool([&]()  {
+        scheduler.run(costs, [&](unsigned i)  {
+            string result = task(i);
+            {
+                lock_guard<mutex> lock(m);
+                results[i].swap(result);
+                ready[i] = 1;
+            }
+            cv.notify_one();
+        });
+    });
+
+    for (unsigned i=0; i<n; i++)  {
+        string result;
+        {
+            unique_lock<mutex> lock(m);
+            cv.wait(lock, [&]()  { return ready[i] != 0; });
+            result.swap(results[i]);
+        }
+        sink(i, result);
+    }
+
+    pool.join();
+}
+
+#endif
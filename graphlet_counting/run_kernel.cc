@@ -21,14 +21,18 @@
 #include <string.h>
 #include <limits.h>
 #include "gkernel.h"
+#include "backbone.h"
 #include "string.h"
+#include "text_reader.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 using namespace std;
 
 
 void print_help()  {
-    cout << "Usage: run_kernel -p FILE -n FILE -g G_FILE -l L_FILE -t TYPE -[k|s] OUTPUT [...]\n";
+    cout << "Usage: run_kernel -p FILE -n FILE -g G_FILE -l L_FILE -t TYPE -[k|s|b|y] OUTPUT [...]\n";
     cout << "Options:\n\n";
 
     cout << "  -h         Displays this message.\n\n";
@@ -38,8 +42,28 @@ void print_help()  {
 
     cout << "  -p FILE    List of positive (vertices) examples.\n";
     cout << "  -n FILE    List of negative (vertices) examples.\n";
-    cout << "  -g G_FILE  Input graph file.\n";
-    cout << "  -l L_FILE  Vertex labels file for input graph.\n\n";
+    cout << "  -g G_FILE  Input graph file, text or binary (written by convert_graph, with the vertex labels).\n";
+    cout << "  -l L_FILE  Vertex labels file for input graph.\n";
+    cout << "  -x COORDS  Atom coordinates file (one \"x y z\" line per vertex label). Builds the contact graph instead of reading G_FILE.\n";
+    cout << "  -P PDB     Structure file (PDB, or mmCIF if named .cif). Builds the contact graph of the N, CA and C atoms of chain A instead of reading G_FILE and L_FILE.\n";
+    cout << "  -d DIST    Contact distance for the graph built from COORDS or PDB.\n";
+    cout << "             A comma-separated list (e.g. 6,7.5,9) computes the distances once and writes one output per distance, named OUTPUT with _dDIST before its extension.\n";
+    cout << "             Distances must be positive and distinct.\n";
+    cout << "             Defaults to 7.5.\n\n";
+
+    cout << "  -K NEAREST Keep only contacts among the NEAREST closest of either atom (COORDS or PDB).\n";
+    cout << "  -D MAXDEG  Keep contacts shortest first while both atoms have fewer than MAXDEG (COORDS or PDB).\n";
+    cout << "  -Q MINSEP  Drop contacts between residues fewer than MINSEP apart in sequence, except backbone bonds.\n";
+    cout << "  -i RES     Residue of every vertex (.atom_res_indices file), for -Q. Taken from PDB if not given.\n";
+    cout << "             Each limit bounds the degree and so the counting time per vertex; 0 (default) is no limit.\n\n";
+
+    cout << "  -O ORDER   Vertex numbering while counting (0-Input order, 1-Reverse Cuthill-McKee, 2-Hilbert curve of the atoms, needs COORDS or PDB).\n";
+    cout << "             Outputs are the same for every order; 1 and 2 keep neighborhoods close in memory on large graphs.\n";
+    cout << "             Defaults to 0.\n\n";
+
+    cout << "  -r ROOTS   Order in which the examples are processed (0-As listed, 1-Breadth-first over the graph, 2-Hilbert curve of the atoms, needs COORDS or PDB).\n";
+    cout << "             Outputs stay in the order of the examples files; 1 and 2 let consecutive examples share their neighborhoods.\n";
+    cout << "             Defaults to 0.\n\n";
 
     cout << "  -N         Normalize the kernel matrix.\n";
     cout << "             Defaults to false.\n\n";
@@ -47,7 +71,25 @@ void print_help()  {
     cout << "  -k KERNEL  Output file for the kernel matrix in standard output.\n";
     cout << "   or\n";
     cout << "  -s SPARSE  Output file for the sparse attribute matrix (SVML).\n";
-    cout << "             Defaults to KERNEL.\n\n";
+    cout << "   or\n";
+    cout << "  -b CSR     Output prefix for the sparse attribute matrix as CSR arrays in NumPy files:\n";
+    cout << "             CSR.indptr.npy (int64), CSR.indices.npy (int64 feature ids), CSR.data.npy (float32),\n";
+    cout << "             CSR.labels.npy (int32 class labels) and CSR.roots.npy (uint32 vertex of each row).\n";
+    cout << "   or\n";
+    cout << "  -y POST    Output file for the posterior of every example under MODEL (float64 NumPy file, in example order).\n";
+    cout << "             The features are scored as they are counted, without writing them.\n";
+    cout << "             Output defaults to the kernel matrix (-k).\n\n";
+
+    cout << "  -V VOCAB   Feature vocabulary file: SPARSE or CSR features are numbered as its columns 0..F-1 instead of by feature id.\n";
+    cout << "             Features not in VOCAB get the next columns and are added to it (created if missing).\n";
+    cout << "  -m MODEL   Calibrated linear SVM for -y, written by export_svm_model.py.\n\n";
+
+    cout << "  -e RESPOST Output file for the posterior of every residue (float64 NumPy file), with -y: one per run of\n";
+    cout << "             consecutive examples in the same residue (RES, or taken from PDB).\n";
+    cout << "  -a REDUCE  Reduction of the posteriors of the atoms of a residue (0-Mean, 1-Maximum, 2-Noisy-OR).\n";
+    cout << "             Defaults to 0.\n\n";
+
+    cout << "  -F         Freeze VOCAB: features not in it are dropped and the file is left unchanged (e.g. the columns of a trained model).\n\n";
 
     cout << "  -I STEPS   Number of steps. (Needed for Random Walk Kernels)\n";
     cout << "             Defaults to 100,000 steps.\n\n";
@@ -70,9 +112,37 @@ void print_help()  {
 
     cout << "  -c LABELS  Output file for each example class label.\n\n";
 
+    cout << "  -j THREADS Number of threads used to count graphlets of the vertices of interest (0 uses all hardware threads).\n";
+    cout << "             Defaults to 1.\n\n";
+
     cout << "  -v         Verbose (prints progress messages).\n\n"; 
 }
 
+// Appends the vertices listed in file (first field of every line) to examples, with class label.
+void read_examples(const string &file, const char *kind, int label, vector<unsigned> &examples, vector<int> &labels)  {
+    TextReader in;
+    if (!in.open(file.c_str()))  {
+        cerr << "WARNING: " << kind << " file " << file << " cannot be opened." << endl;
+        return;
+    }
+
+    unsigned vertex;
+    while (in.next_line())  {
+        in.next_unsigned(vertex);
+        examples.push_back(vertex);
+        labels.push_back(label);
+    }
+}
+
+// Output file for one of several contact distances: file with _dDIST before its extension.
+string distance_file(const string &file, const string &distance)  {
+    size_t dot = file.rfind('.');
+    size_t slash = file.rfind('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+        return file + "_d" + distance;
+    return file.substr(0, dot) + "_d" + distance + file.substr(dot);
+}
+
 int main(int argc, char* argv[])  {
     typedef enum kerneltype  {
         RANDOM_WALK_CUMULATIVE,
@@ -85,18 +155,34 @@ int main(int argc, char* argv[])  {
 
     typedef enum outformat  {
         KERNEL,
-        SPARSE_SVML
+        SPARSE_SVML,
+        SPARSE_CSR,
+        POSTERIORS
      } OutputFormat;
 
     string pos_file;
     string neg_file;
     string l_file, g_file;
+    string coords_file;
+    string structure_file;
+    string residues_file;
+    string vocabulary_file;
+    string model_file;
+    string residue_posteriors_file;
+    unsigned reduce(REDUCE_MEAN);
+    bool freeze_vocabulary(false);
+    ContactPolicy policy;
+    vector<float> distances(1, CONTACT_THRESHOLD);
+    vector<string> distance_names;
     string output_file;
     OutputFormat format(KERNEL);
     KernelType k_type(STANDARD_GRAPHLET);    
     string labels_file;
     bool normalize(false);
     bool verbose(false);
+    unsigned threads(1);
+    unsigned order(ORDER_FILE);
+    unsigned root_order(ROOTS_INPUT);
 
     // Random Walk Kernels Parameters
     int steps(100000); 
@@ -144,9 +230,62 @@ int main(int argc, char* argv[])  {
             case 'n': i++; neg_file=argv[i]; break;
             case 'g': i++; g_file=argv[i]; break;
             case 'l': i++; l_file=argv[i]; break;
+            case 'x': i++; coords_file=argv[i]; break;
+            case 'P': i++; structure_file=argv[i]; break;
+            case 'd':
+                i++;
+                distance_names = split(argv[i], ',');
+                distances.clear();
+                // Checked here, so that a bad list fails before anything is counted or written.
+                for (unsigned d=0; d<distance_names.size(); d++)  {
+                    char *end;
+                    float distance = strtod(distance_names[d].c_str(), &end);
+                    if (distance_names[d].size() == 0 || *end != '\0' || !(distance > 0) || !isfinite(distance))  {
+                        cerr << "ERROR: Invalid contact distance '" << distance_names[d] << "' in " << argv[i] << endl;  print_help();  exit(1);
+                    }
+                    if (find(distances.begin(), distances.end(), distance) != distances.end())  {
+                        cerr << "ERROR: Repeated contact distance " << distance_names[d] << " in " << argv[i] << endl;  print_help();  exit(1);
+                    }
+                    distances.push_back(distance);
+                }
+                if (distances.size() == 0)  {
+                    cerr << "ERROR: Empty list of contact distances (-d)." << endl;  print_help();  exit(1);
+                }
+                break;
+            case 'K': i++; policy.nearest=to_i(argv[i]); break;
+            case 'D': i++; policy.max_degree=to_i(argv[i]); break;
+            case 'Q': i++; policy.min_separation=to_i(argv[i]); break;
+            case 'i': i++; residues_file=argv[i]; break;
+            case 'O':
+                i++;
+                order = to_i(argv[i]);
+                if (order > ORDER_HILBERT)  {
+                    cerr << "ERROR: Unknown vertex order " << argv[i] << endl;  print_help();  exit(1);
+                }
+                break;
+            case 'r':
+                i++;
+                root_order = to_i(argv[i]);
+                if (root_order > ROOTS_SPATIAL)  {
+                    cerr << "ERROR: Unknown root order " << argv[i] << endl;  print_help();  exit(1);
+                }
+                break;
             case 'N': normalize=true; break;
             case 'k': i++; format=KERNEL; output_file=argv[i]; break;
             case 's': i++; format=SPARSE_SVML; output_file=argv[i]; break;
+            case 'b': i++; format=SPARSE_CSR; output_file=argv[i]; break;
+            case 'V': i++; vocabulary_file=argv[i]; break;
+            case 'F': freeze_vocabulary=true; break;
+            case 'y': i++; format=POSTERIORS; output_file=argv[i]; break;
+            case 'm': i++; model_file=argv[i]; break;
+            case 'e': i++; residue_posteriors_file=argv[i]; break;
+            case 'a':
+                i++;
+                reduce = to_i(argv[i]);
+                if (reduce > REDUCE_NOISY_OR)  {
+                    cerr << "ERROR: Unknown reduction " << argv[i] << endl;  print_help();  exit(1);
+                }
+                break;
             // Kernel-specific parameters                    
             case 'I': i++; steps=to_i(argv[i]); break;
             case 'R': i++; restart=to_f(argv[i]); break;
@@ -170,6 +309,7 @@ int main(int argc, char* argv[])  {
                 break;
             case 'A': i++; alphabet=argv[i]; root_alphabet=argv[i]; break;
             case 'c': i++; labels_file=argv[i]; break;
+            case 'j': i++; threads=to_i(argv[i]); break;
             case 'v': verbose=true; break;
             default: 
                 cerr << "ERROR: Unknown option " << argv[i] << endl;
@@ -181,6 +321,10 @@ int main(int argc, char* argv[])  {
         cerr << "ERROR: Output file name not specified." << endl;  print_help();  exit(1);
     }
 
+    if (distances.size() > 1 && 0 == coords_file.size() && 0 == structure_file.size())  {
+        cerr << "ERROR: Several contact distances need an atom coordinates (-x) or structure (-P) file." << endl;  print_help();  exit(1);
+    }
+
     if (0 == sim_matrix_file.size() && (k_type == LABEL_MISMATCH || k_type == EDIT_DISTANCE))  {
         // User-defined probability similarity matrix
         // Use default matrix
@@ -191,39 +335,32 @@ int main(int argc, char* argv[])  {
         cerr << "ERROR: Alphabet for the vertex labels not specified. It is required for selected kernel type." << endl;  print_help();  exit(1);
     }
 
+    if (format == POSTERIORS && 0 == model_file.size())  {
+        cerr << "ERROR: Posteriors (-y) need a model file (-m)." << endl;  print_help();  exit(1);
+    }
+
+    if (residue_posteriors_file.size() > 0 && format != POSTERIORS)  {
+        cerr << "ERROR: Residue posteriors (-e) need atom posteriors (-y)." << endl;  print_help();  exit(1);
+    }
+
+    if (residue_posteriors_file.size() > 0 && 0 == residues_file.size() && 0 == structure_file.size())  {
+        cerr << "ERROR: Residue posteriors (-e) need a residue indices (-i) or structure (-P) file." << endl;  print_help();  exit(1);
+    }
+
+    if (format == POSTERIORS && k_type != STANDARD_GRAPHLET && k_type != LABEL_MISMATCH && k_type != EDGE_MISMATCH && k_type != EDIT_DISTANCE)  {
+        cerr << "ERROR: Posteriors (-y) need a graphlet kernel type (-t 2 to 5)." << endl;  print_help();  exit(1);
+    }
+
     GraphKernel gk;
 
-    string line;
     vector<unsigned> examples;
     vector<int> labels;
 
     // Read list of positive examples.
-    ifstream p(pos_file.c_str(), ios::in);
-    if (p.fail()) {
-        cerr << "WARNING: Positives file " << pos_file << " cannot be opened." << endl;
-    }
-    else  {
-        while(getline(p, line))  {
-            vector<string> tokens = split(line, '\t');            
-            examples.push_back(to_i(strip(tokens[0])));
-            labels.push_back(1);
-        }
-    }
-    p.close();
+    read_examples(pos_file, "Positives", 1, examples, labels);
 
 	// Read list of negative examples.
-    ifstream n(neg_file.c_str(), ios::in);
-    if (n.fail())  {
-        cerr << "WARNING: Negatives file " << neg_file << " cannot be opened." << endl;
-    }
-    else  {
-        while(getline(n, line))  {
-            vector<string> tokens = split(line, '\t');        
-            examples.push_back(to_i(strip(tokens[0])));
-            labels.push_back(-1);
-        }
-    }
-    n.close();
+    read_examples(neg_file, "Negatives", -1, examples, labels);
 
     if (examples.size() < 1)  {
         cerr << "ERROR: Too few examples." << endl << endl; print_help(); exit(1);
@@ -231,87 +368,159 @@ int main(int argc, char* argv[])  {
 
     if (normalize)  gk.set_normalize();
     if (verbose)  gk.set_verbose();
+    gk.set_threads(threads);
+    gk.set_vertex_order(order);
+    gk.set_root_order(root_order);
+    if (format == SPARSE_CSR)  gk.set_sparse_csr();
+
+    SvmModel model;
+    if (format == POSTERIORS)  {
+        model.open(model_file.c_str());
+        gk.set_svm_model(&model);
+    }
 
-    gk.read_graphs(l_file, g_file, examples);
+    FeatureVocabulary vocabulary;
+    if (vocabulary_file.size() > 0)  {
+        if (!vocabulary.read(vocabulary_file.c_str()) && freeze_vocabulary)  {
+            cerr << "ERROR: Vocabulary file " << vocabulary_file << " could not be opened." << endl;  exit(1);
+        }
+        if (freeze_vocabulary)
+            vocabulary.freeze();
+        gk.set_feature_vocabulary(&vocabulary);
+    }
+    else if (freeze_vocabulary)  {
+        cerr << "ERROR: Vocabulary file to freeze (-V) not specified." << endl;  print_help();  exit(1);
+    }
+
+    vector<unsigned> residues;
+    if (residues_file.size() > 0)
+        residues = read_residue_indices(residues_file.c_str());
+
+    if (structure_file.size() > 0 || coords_file.size() > 0)  {
+        AtomCoordinates atoms;
+        string atom_labels;
+        if (structure_file.size() > 0)  {
+            Backbone backbone = read_backbone(structure_file.c_str());
+            atoms = backbone.atoms;
+            atom_labels = backbone.labels;
+            if (residues_file.size() == 0)
+                residues = backbone.residue_indices;
+        }
+        else  {
+            atoms = read_coordinates(coords_file.c_str());
+            atom_labels = SimpleGraph::read_labels(l_file.c_str());
+        }
+
+        gk.set_contact_policy(policy, residues);
+
+        if (distances.size() > 1)
+            gk.read_contact_distances(atoms, atom_labels, *max_element(distances.begin(), distances.end()), examples);
+        else
+            gk.read_contact_graph(atoms, atom_labels, distances[0], examples);
+    }
+    else  {
+        if (policy.by_distance())  {
+            cerr << "ERROR: Limits on the nearest contacts (-K) or the degree (-D) need an atom coordinates (-x) or structure (-P) file." << endl;  print_help();  exit(1);
+        }
+        gk.set_contact_policy(policy, residues);
+        gk.read_graphs(l_file, g_file, examples);
+    }
     gk.set_labels(labels);
 
-    switch (format)  {
-        case KERNEL:
-			switch (k_type)  {
-				case RANDOM_WALK_CUMULATIVE:
-					gk.compute_random_walk_cumulative_matrix(steps, restart);
-					break;
-				case RANDOM_WALK:
-					gk.compute_random_walk_matrix(steps, restart);
-					break;
-				case STANDARD_GRAPHLET:
-					gk.set_number_label_mismatches(0.0);
-					gk.compute_label_mismatch_matrix();
-					break;
-				case LABEL_MISMATCH:
-					gk.set_number_label_mismatches(mismatches);
-					gk.set_label_mismatches_alphabet(alphabet);
-					gk.set_label_mismatches_root_alphabet(root_alphabet);
-					gk.read_sim_matrix(sim_matrix_file);
-					gk.compute_label_mismatch_matrix();
-					break;
-				case EDGE_MISMATCH:
-					gk.set_number_edges_mismatches(edgmis);
-                    gk.compute_edge_mismatch_matrix();
-					break;
-                case EDIT_DISTANCE:
-                    gk.set_number_label_mismatches(mismatches);
-                    gk.set_label_mismatches_alphabet(alphabet);
-                    gk.set_label_mismatches_root_alphabet(root_alphabet);
-                    gk.read_sim_matrix(sim_matrix_file);
-                    gk.set_number_edges_mismatches(edgmis);
-                    if (edgmis == 2)
-                        gk.compute_edit_distance2_matrix();
-                    else
-                        gk.compute_edit_distance_matrix();
-                    break;
-			}
-			gk.write_matrix(output_file.c_str());
-            break;
-        case SPARSE_SVML:
-            switch (k_type)  {
-				case RANDOM_WALK_CUMULATIVE:
-                    gk.compute_random_walk_cumulative_matrix(steps, restart);
-                    break;
-                case RANDOM_WALK:
-                    gk.compute_random_walk_matrix(steps, restart);
-					break;
-				case STANDARD_GRAPHLET:
-					gk.set_number_label_mismatches(0.0);
-					gk.write_sparse_svml_lm(output_file.c_str());
-					break;
-				case LABEL_MISMATCH:
-					gk.set_number_label_mismatches(mismatches);
-					gk.set_label_mismatches_alphabet(alphabet);
-					gk.set_label_mismatches_root_alphabet(root_alphabet);
-					gk.read_sim_matrix(sim_matrix_file);
-					gk.write_sparse_svml_lm(output_file.c_str());
-					break;
-				case EDGE_MISMATCH:
-                    gk.set_number_edges_mismatches(edgmis);
-					gk.write_sparse_svml_em(output_file.c_str());
-                    break;
-                case EDIT_DISTANCE:
-                    gk.set_number_label_mismatches(mismatches);
-                    gk.set_label_mismatches_alphabet(alphabet);
-                    gk.set_label_mismatches_root_alphabet(root_alphabet);
-                    gk.read_sim_matrix(sim_matrix_file);
-                    gk.set_number_edges_mismatches(edgmis);
-                    if (edgmis == 2)
-                        gk.write_sparse_svml_ed2(output_file.c_str()); 
-                    else
-                        gk.write_sparse_svml_ed(output_file.c_str());
-            }
+    // One pass per contact distance; the contacts were found once for all of them.
+    for (unsigned d=0; d<distances.size(); d++)  {
+        string out_file = output_file;
+        if (distances.size() > 1)  {
+            gk.set_contact_threshold(distances[d]);
+            out_file = distance_file(output_file, distance_names[d]);
+        }
+
+        switch (format)  {
+            case KERNEL:
+    			switch (k_type)  {
+    				case RANDOM_WALK_CUMULATIVE:
+    					gk.compute_random_walk_cumulative_matrix(steps, restart);
+    					break;
+    				case RANDOM_WALK:
+    					gk.compute_random_walk_matrix(steps, restart);
+    					break;
+    				case STANDARD_GRAPHLET:
+    					gk.set_number_label_mismatches(0.0);
+    					gk.compute_label_mismatch_matrix();
+    					break;
+    				case LABEL_MISMATCH:
+    					gk.set_number_label_mismatches(mismatches);
+    					gk.set_label_mismatches_alphabet(alphabet);
+    					gk.set_label_mismatches_root_alphabet(root_alphabet);
+    					gk.read_sim_matrix(sim_matrix_file);
+    					gk.compute_label_mismatch_matrix();
+    					break;
+    				case EDGE_MISMATCH:
+    					gk.set_number_edges_mismatches(edgmis);
+                        gk.compute_edge_mismatch_matrix();
+    					break;
+                    case EDIT_DISTANCE:
+                        gk.set_number_label_mismatches(mismatches);
+                        gk.set_label_mismatches_alphabet(alphabet);
+                        gk.set_label_mismatches_root_alphabet(root_alphabet);
+                        gk.read_sim_matrix(sim_matrix_file);
+                        gk.set_number_edges_mismatches(edgmis);
+                        if (edgmis == 2)
+                            gk.compute_edit_distance2_matrix();
+                        else
+                            gk.compute_edit_distance_matrix();
+                        break;
+    			}
+    			gk.write_matrix(out_file.c_str());
+                break;
+            case SPARSE_SVML:
+            case SPARSE_CSR:
+            case POSTERIORS:
+                switch (k_type)  {
+    				case RANDOM_WALK_CUMULATIVE:
+                        gk.compute_random_walk_cumulative_matrix(steps, restart);
+                        break;
+                    case RANDOM_WALK:
+                        gk.compute_random_walk_matrix(steps, restart);
+    					break;
+    				case STANDARD_GRAPHLET:
+    					gk.set_number_label_mismatches(0.0);
+    					gk.write_sparse_svml_lm(out_file.c_str());
+    					break;
+    				case LABEL_MISMATCH:
+    					gk.set_number_label_mismatches(mismatches);
+    					gk.set_label_mismatches_alphabet(alphabet);
+    					gk.set_label_mismatches_root_alphabet(root_alphabet);
+    					gk.read_sim_matrix(sim_matrix_file);
+    					gk.write_sparse_svml_lm(out_file.c_str());
+    					break;
+    				case EDGE_MISMATCH:
+                        gk.set_number_edges_mismatches(edgmis);
+    					gk.write_sparse_svml_em(out_file.c_str());
+                        break;
+                    case EDIT_DISTANCE:
+                        gk.set_number_label_mismatches(mismatches);
+                        gk.set_label_mismatches_alphabet(alphabet);
+                        gk.set_label_mismatches_root_alphabet(root_alphabet);
+                        gk.read_sim_matrix(sim_matrix_file);
+                        gk.set_number_edges_mismatches(edgmis);
+                        if (edgmis == 2)
+                            gk.write_sparse_svml_ed2(out_file.c_str()); 
+                        else
+                            gk.write_sparse_svml_ed(out_file.c_str());
+                }
+        }
+
+        if (residue_posteriors_file.size() > 0)
+            gk.write_residue_posteriors((distances.size() > 1 ? distance_file(residue_posteriors_file, distance_names[d]) : residue_posteriors_file).c_str(), reduce);
     }
 
     if (labels_file.size() > 0)
         gk.write_labels(labels_file.c_str());
 
+    if (vocabulary_file.size() > 0 && !freeze_vocabulary)
+        vocabulary.write(vocabulary_file.c_str());
+
     exit(0);
 }
 
@@ -1,65 +1,291 @@
 #include "simgraph.h"
 #include "string.h"
+#include "text_reader.h"
+#include <algorithm>
 #include <fstream>
 #include <set>
 #include <queue>
 
 
 SimpleGraph SimpleGraph::read_graph(const char *nlabels_file, const char *graph_file)  {
-    ifstream lin(nlabels_file, ios::in);
-    ifstream gin(graph_file, ios::in);
+    SimpleGraph g;
 
-    if (lin.fail())  {
-        cerr << "ERROR: Node labels file " << nlabels_file << " could not be opened." << endl; exit(1);
-    }
+    // Read graph labels
+    g.nodes = read_labels(nlabels_file);
 
-    if (gin.fail())  {
+    TextReader gin;
+    if (!gin.open(graph_file))  {
         cerr << "ERROR: Graph file " << graph_file << " could not be opened." << endl; exit(1);
     }
 
-    SimpleGraph g;
-
-    // Read graph labels
-    string line;
-    if (getline(lin,line))
-        g.nodes = line;    
-
     // Size of the graph is determined by the number of node labels
     g.adj.resize(g.nodes.size());
 
     // Read graph
-    // Parse adjacency list
-    while(getline(gin, line))  {
-        vector<string> tokens = split(line, '\t');
-        unsigned i = to_i(tokens[0]);
+    // Parse adjacency list: "i k1 k2 ...", fields separated by spaces or tabs.
+    // Repeated neighbors are dropped; mark[k] == line number if k is already in row i.
+    vector<size_t> mark(g.adj.size(), 0);
+    while (gin.next_line())  {
+        unsigned i, k;
+        gin.next_unsigned(i);
 
         if (i >= g.adj.size())  {
             cerr << "ERROR: Node index " << i << " >= graph size " << g.adj.size() << " in graph file " << graph_file << "." << endl; exit(1);
         }
 
-        for (unsigned j=1; j<tokens.size(); j++)  {
-            unsigned k = to_i(tokens[j]);
-            bool found(false);
+        size_t line = gin.line_number();
+        for (unsigned t=0; t<g.adj[i].size(); t++)
+            mark[g.adj[i][t]] = line;
 
+        while (gin.next_unsigned(k))  {
             if (k >= g.adj.size())  {
                 cerr << "ERROR: Node index " << k << " >= graph size " << g.adj.size() << " in graph file " << graph_file << "." << endl; exit(1);
             }
 
-            for (vector<unsigned>::iterator it = g.adj[i].begin(); it < g.adj[i].end(); it++)  {
-                if (*it == k) {
-                    found = true;
+            if (mark[k] != line)  {
+                mark[k] = line;
+                g.adj[i].push_back(k);
+            }
+        }
+    }
+
+    g.index_edges();
+    return g;
+}
+
+
+string SimpleGraph::read_labels(const char *nlabels_file)  {
+    ifstream lin(nlabels_file, ios::in);
+    if (lin.fail())  {
+        cerr << "ERROR: Node labels file " << nlabels_file << " could not be opened." << endl; exit(1);
+    }
+
+    string line;
+    getline(lin, line);
+    return line;
+}
+
+
+void BfsBuffers::start(size_t n)  {
+    if (stamp.size() < n)  {
+        stamp.resize(n, 0);
+        position.resize(n);
+    }
+    if (++epoch == 0)  {
+        // Wrapped around: stamps of old searches could match again.
+        fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+    order.clear();
+    level.clear();
+}
+
+
+void MultiSourceBfs::get(unsigned s, BfsBuffers &bfs) const  {
+    unsigned long long bit = 1ULL << s;
+    unsigned levels = depth + 1;
+
+    bfs.start(graph_size);
+    bfs.visit(sources[s], 0);
+    for (unsigned i=0; i<vertices.size(); i++)  {
+        if (!(seen[i] & bit) || vertices[i] == sources[s])
+            continue;
+        unsigned d = 1;
+        while (!(masks[(size_t) i * levels + d] & bit))
+            d++;
+        bfs.visit(vertices[i], d);
+    }
+}
+
+
+void SimpleGraph::bounded_bfs(unsigned root, unsigned depth, BfsBuffers &bfs) const  {
+    bfs.start(nodes.size());
+    bfs.visit(root, 0);
+
+    for (unsigned q=0; q<bfs.order.size() && bfs.level[q] < depth; q++)  {
+        const vector<unsigned> &nbrs = adj[bfs.order[q]];
+        for (unsigned t=0; t<nbrs.size(); t++)  {
+            if (!bfs.visited(nbrs[t]))
+                bfs.visit(nbrs[t], bfs.level[q] + 1);
+        }
+    }
+}
+
+
+void SimpleGraph::multi_source_bfs(const unsigned *sources, unsigned count, unsigned depth, MultiSourceBfs &batch, BfsBuffers &scratch) const  {
+    unsigned levels = depth + 1;
+    vector<unsigned> frontier, next;
+    vector<unsigned long long> &seen = batch.seen; // Sources that reach each vertex in at most d hops so far.
+
+    batch.sources.assign(sources, sources + count);
+    batch.vertices.clear();
+    batch.masks.clear();
+    seen.clear();
+    batch.depth = depth;
+    batch.graph_size = nodes.size();
+
+    // scratch.order mirrors batch.vertices, so scratch.index(v) is the index of v in the batch.
+    scratch.start(nodes.size());
+    for (unsigned s=0; s<count; s++)  {
+        unsigned v = sources[s];
+        if (!scratch.visited(v))  {
+            scratch.visit(v, 0);
+            batch.vertices.push_back(v);
+            batch.masks.resize(batch.masks.size() + levels, 0);
+            seen.push_back(0);
+            frontier.push_back(scratch.position[v]);
+        }
+        batch.masks[(size_t) scratch.position[v] * levels] |= 1ULL << s;
+        seen[scratch.position[v]] |= 1ULL << s;
+    }
+
+    for (unsigned d=1; d<levels; d++)  {
+        next.clear();
+        for (unsigned f=0; f<frontier.size(); f++)  {
+            unsigned i = frontier[f];
+            unsigned long long reach = batch.masks[(size_t) i * levels + d - 1];
+            const vector<unsigned> &nbrs = adj[batch.vertices[i]];
+            for (unsigned t=0; t<nbrs.size(); t++)  {
+                unsigned u = nbrs[t];
+                if (!scratch.visited(u))  {
+                    scratch.visit(u, d);
+                    batch.vertices.push_back(u);
+                    batch.masks.resize(batch.masks.size() + levels, 0);
+                    seen.push_back(0);
                 }
+                unsigned j = scratch.position[u];
+                unsigned long long fresh = reach & ~seen[j];
+                if (fresh == 0)
+                    continue;
+                if (batch.masks[(size_t) j * levels + d] == 0)
+                    next.push_back(j);
+                batch.masks[(size_t) j * levels + d] |= fresh;
+                seen[j] |= fresh;
             }
-            if (!found)  {
-                g.adj[i].push_back(k);
+        }
+        frontier.swap(next);
+    }
+}
+
+
+void SimpleGraph::extract_neighborhood(unsigned root, unsigned depth, BfsBuffers &bfs, SimpleGraph &local) const  {
+    bounded_bfs(root, depth, bfs);
+    extract_neighborhood(depth, bfs, local);
+}
+
+
+void SimpleGraph::extract_neighborhood(unsigned depth, const BfsBuffers &bfs, SimpleGraph &local) const  {
+    unsigned n = bfs.order.size();
+    local.nodes.resize(n);
+    local.adj.resize(n);
+    for (unsigned v=0; v<n; v++)  {
+        unsigned u = bfs.order[v];
+        local.nodes[v] = nodes[u];
+        local.adj[v].clear();
+        if (bfs.level[v] == depth)
+            continue;
+        for (unsigned t=0; t<adj[u].size(); t++)
+            local.adj[v].push_back(bfs.position[adj[u][t]]);
+    }
+    local.index_edges(MAX_LOCAL_VERTICES);
+}
+
+
+vector<unsigned> SimpleGraph::rcm_order() const  {
+    unsigned n = adj.size();
+    vector<unsigned> by_degree(n), order;
+    vector<bool> placed(n, false);
+    order.reserve(n);
+
+    for (unsigned v=0; v<n; v++)
+        by_degree[v] = v;
+    stable_sort(by_degree.begin(), by_degree.end(), [&](unsigned u, unsigned v)  { return adj[u].size() < adj[v].size(); });
+
+    // order doubles as the BFS queue of the current component.
+    for (unsigned s=0; s<n; s++)  {
+        if (placed[by_degree[s]])
+            continue;
+        placed[by_degree[s]] = true;
+        order.push_back(by_degree[s]);
+        for (unsigned q=order.size()-1; q<order.size(); q++)  {
+            size_t first = order.size();
+            const vector<unsigned> &nbrs = adj[order[q]];
+            for (unsigned t=0; t<nbrs.size(); t++)  {
+                if (!placed[nbrs[t]])  {
+                    placed[nbrs[t]] = true;
+                    order.push_back(nbrs[t]);
+                }
             }
+            stable_sort(order.begin() + first, order.end(), [&](unsigned u, unsigned v)  { return adj[u].size() < adj[v].size(); });
         }
     }
 
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+
+SimpleGraph SimpleGraph::permuted(const vector<unsigned> &order) const  {
+    unsigned n = adj.size();
+    vector<unsigned> rank(n);
+    for (unsigned v=0; v<n; v++)
+        rank[order[v]] = v;
+
+    SimpleGraph g;
+    g.nodes.resize(n);
+    g.adj.resize(n);
+    for (unsigned v=0; v<n; v++)  {
+        const vector<unsigned> &row = adj[order[v]];
+        g.nodes[v] = nodes[order[v]];
+        g.adj[v].resize(row.size());
+        for (unsigned t=0; t<row.size(); t++)
+            g.adj[v][t] = rank[row[t]];
+    }
+
+    g.index_edges();
     return g;
 }
 
 
+void SimpleGraph::index_edges(unsigned max_bitset_vertices)  {
+    unsigned n = adj.size();
+    size_t edges = 0;
+    for (unsigned i=0; i<n; i++)
+        edges += adj[i].size();
+
+    // Past max_bitset_vertices, zeroing the matrix must not cost more than
+    // copying the adjacency lists did: dense neighborhoods keep the faster
+    // bit tests, large sparse ones are not charged n^2 bits.
+    row_words = (n + 63) / 64;
+    bool bitset = n <= MAX_BITSET_VERTICES && (n <= max_bitset_vertices || (size_t) n * row_words <= edges);
+
+    adj_bits.clear();
+    edge_set.clear();
+    if (bitset)  {
+        adj_bits.assign((size_t) n * row_words, 0);
+        for (unsigned i=0; i<n; i++)
+            for (unsigned t=0; t<adj[i].size(); t++)
+                adj_bits[(size_t) i * row_words + (adj[i][t] >> 6)] |= 1ULL << (adj[i][t] & 63);
+    }
+    else  {
+        size_t capacity = 16;
+        while (capacity < 2 * edges)
+            capacity <<= 1;
+        edge_set.assign(capacity, NO_EDGE);
+        edge_mask = capacity - 1;
+        for (unsigned i=0; i<n; i++)  {
+            for (unsigned t=0; t<adj[i].size(); t++)  {
+                unsigned long long e = edge_id(i, adj[i][t]);
+                size_t s = edge_slot(e);
+                while (edge_set[s] != NO_EDGE && edge_set[s] != e)
+                    s = (s + 1) & edge_mask;
+                edge_set[s] = e;
+            }
+        }
+    }
+}
+
+
 void SimpleGraph::print_dot(ostream &out)  {
     out << "graph PCG {\n";
     out << "    node [shape=circle,style=filled,color=lightgray]; {node [label=\"" << nodes[0] << "\"] n0; }\n";
@@ -19,19 +19,102 @@
 #ifndef __SIMPLE_GRAPH_H__
 #define __SIMPLE_GRAPH_H__
 
+#define MAX_BITSET_VERTICES 8192 // Larger graphs index their edges in a hash set instead of a bit matrix (8 MB).
+#define MAX_LOCAL_VERTICES 256   // Extracted neighborhoods up to this size get a bit matrix (8 KB, in L1); see index_edges.
+#define BFS_BATCH 64             // Sources of a multi-source search, one bit each of a 64-bit word.
+
+#include <climits>
 #include <iostream>
+#include <string>
 #include <vector>
 using namespace std;
 
 
+/** Scratch space of SimpleGraph::bounded_bfs. It is sized once for the graph
+ *  and reused across sources: instead of clearing the per-vertex arrays, every
+ *  search bumps the epoch, and entries stamped with an older epoch count as
+ *  unvisited. Keep one per thread. */
+class BfsBuffers  {
+public:
+    BfsBuffers() : epoch(0)  {}
+    ~BfsBuffers()  {}
+
+    /** Distance of v from the last source, UINT_MAX if v was not reached. */
+    inline unsigned distance(unsigned v) const  { return visited(v) ? level[position[v]] : UINT_MAX; }
+
+    /** Index of v in order, UINT_MAX if v was not reached. */
+    inline unsigned index(unsigned v) const  { return visited(v) ? position[v] : UINT_MAX; }
+
+    vector<unsigned> order; // Reached vertices, source first (in BFS order after bounded_bfs).
+    vector<unsigned> level; // level[q] is the distance of order[q] from the source.
+
+private:
+    friend class SimpleGraph;
+    friend class MultiSourceBfs;
+
+    inline bool visited(unsigned v) const  { return v < stamp.size() && stamp[v] == epoch; }
+
+    /** Starts a new search on a graph with n vertices. */
+    void start(size_t n);
+
+    /** Appends v, which must not have been reached yet, at distance d. */
+    inline void visit(unsigned v, unsigned d)  {
+        stamp[v] = epoch;
+        position[v] = order.size();
+        order.push_back(v);
+        level.push_back(d);
+    }
+
+    vector<unsigned> stamp;    // Epoch of the last search that reached each vertex.
+    vector<unsigned> position; // Index in order, valid where stamp == epoch.
+    unsigned epoch;
+};
+
+
+/** Result of SimpleGraph::multi_source_bfs: bounded breadth-first searches
+ *  from up to BFS_BATCH sources run together, MS-BFS style. Each reached
+ *  vertex has one word per level with the bits of the sources that reach it
+ *  at that distance, so a vertex shared by the neighborhoods of many sources
+ *  is expanded once per level rather than once per source. */
+class MultiSourceBfs  {
+public:
+    MultiSourceBfs() : depth(0), graph_size(0)  {}
+    ~MultiSourceBfs()  {}
+
+    inline unsigned size() const  { return sources.size(); }
+    inline unsigned source(unsigned s) const  { return sources[s]; }
+
+    /** Number of vertices reached from at least one source. */
+    inline unsigned reached() const  { return vertices.size(); }
+
+    /** Leaves the search from the s-th source in bfs, as bounded_bfs would,
+     *  except that after the source the vertices come in the order the batch
+     *  discovered them, which is not sorted by distance. */
+    void get(unsigned s, BfsBuffers &bfs) const;
+
+private:
+    friend class SimpleGraph;
+
+    vector<unsigned> sources;
+    vector<unsigned> vertices;        // Reached vertices in discovery order.
+    vector<unsigned long long> masks; // masks[i*(depth+1)+d]: sources that reach vertices[i] in exactly d hops.
+    vector<unsigned long long> seen;  // seen[i]: sources that reach vertices[i] at all.
+    unsigned depth;
+    unsigned graph_size;
+};
+
+
 class SimpleGraph  {
 public:
-    SimpleGraph()  {}
+    SimpleGraph() : row_words(0), edge_mask(0)  {}
     ~SimpleGraph()  {}    
 
     /** Read an adjacency list file and create a graph. */
     static SimpleGraph read_graph(const char*, const char*);
 
+    /** Reads the vertex labels file of a graph (one character per vertex). */
+    static string read_labels(const char*);
+
     /** Generates a GraphViz file. */
     void print_dot(ostream&);
 
@@ -41,8 +124,92 @@ public:
     /** Breadth-first assignment of distances from a source node. */ 
     vector<unsigned> breadth_first_sort(unsigned) const;
 
-    string nodes;                  // Vertex labels.
+    /** Breadth-first search from root that stops depth hops away. The reached
+     *  vertices and their distances are left in bfs.order and bfs.level; the
+     *  cost depends on the size of the neighborhood, not of the graph. */
+    void bounded_bfs(unsigned root, unsigned depth, BfsBuffers &bfs) const;
+
+    /** Bounded breadth-first searches from sources[0..count), count <= BFS_BATCH,
+     *  all at once into batch. scratch maps vertices to their index in the batch. */
+    void multi_source_bfs(const unsigned *sources, unsigned count, unsigned depth, MultiSourceBfs &batch, BfsBuffers &scratch) const;
+
+    /** Copies the subgraph induced by the vertices within depth hops of root
+     *  into local, with vertex q of local being bfs.order[q] (root is 0), so
+     *  bfs.level holds the local distances. Adjacency lists keep their order;
+     *  vertices at distance depth are leaves with empty lists, so edges can
+     *  only be tested from the inner vertices. local is indexed with
+     *  index_edges(MAX_LOCAL_VERTICES). */
+    void extract_neighborhood(unsigned root, unsigned depth, BfsBuffers &bfs, SimpleGraph &local) const;
+
+    /** Same as above, for a search to the given depth already in bfs. */
+    void extract_neighborhood(unsigned depth, const BfsBuffers &bfs, SimpleGraph &local) const;
+
+    /** Reverse Cuthill-McKee order of the vertices: order[v] is the vertex to
+     *  number v. Breadth-first from a vertex of least degree in every component,
+     *  visiting neighbors by increasing degree, so adjacent vertices get close
+     *  numbers. */
+    vector<unsigned> rcm_order() const;
+
+    /** Copy of the graph with vertex v being vertex order[v] of this one.
+     *  Adjacency lists keep their order, so enumeration visits the same
+     *  graphlets in the same order. */
+    SimpleGraph permuted(const vector<unsigned> &order) const;
+
+    /** Removes every edge {i,j} for which keep(i, j) is false; keep must be
+     *  symmetric. The remaining neighbors keep their order. */
+    template <class Keep>
+    void filter_edges(Keep keep)  {
+        for (unsigned i=0; i<adj.size(); i++)  {
+            unsigned kept = 0;
+            for (unsigned t=0; t<adj[i].size(); t++)  {
+                if (keep(i, adj[i][t]))
+                    adj[i][kept++] = adj[i][t];
+            }
+            adj[i].resize(kept);
+        }
+        index_edges();
+    }
+
+    /** Builds the edge index behind has_edge: a bit matrix for graphs of up to
+     *  max_bitset_vertices vertices, or for larger ones up to MAX_BITSET_VERTICES
+     *  whose matrix has no more words than adj has entries; a hash set otherwise.
+     *  Must be called again whenever adj changes. */
+    void index_edges(unsigned max_bitset_vertices = MAX_BITSET_VERTICES);
+
+    /** True if j is in the adjacency list of i, in O(1). Needs index_edges(). */
+    inline bool has_edge(unsigned i, unsigned j) const  {
+        if (!adj_bits.empty())
+            return (adj_bits[(size_t) i * row_words + (j >> 6)] >> (j & 63)) & 1;
+
+        unsigned long long e = edge_id(i, j);
+        for (size_t s = edge_slot(e); edge_set[s] != NO_EDGE; s = (s + 1) & edge_mask)  {
+            if (edge_set[s] == e)
+                return true;
+        }
+        return false;
+    }
+
+    /** True if index_edges built a bit matrix, so bit_row can be used. */
+    inline bool has_bit_matrix() const  { return !adj_bits.empty(); }
+
+    /** Neighbors of i as a bit row of bit_row_words() 64-bit words (bit j of
+     *  the row is set if j is adjacent to i). Needs has_bit_matrix(). */
+    inline const unsigned long long *bit_row(unsigned i) const  { return &adj_bits[(size_t) i * row_words]; }
+    inline size_t bit_row_words() const  { return row_words; }
+
+    string nodes;                // Vertex labels.
     vector<vector<unsigned> > adj; // Adjacency lists.
+
+private:
+    static constexpr unsigned long long NO_EDGE = ~0ULL;
+
+    static inline unsigned long long edge_id(unsigned i, unsigned j)  { return ((unsigned long long) i << 32) | j; }
+    inline size_t edge_slot(unsigned long long e) const  { return (size_t) ((e * 0x9E3779B97F4A7C15ULL) >> 32) & edge_mask; }
+
+    vector<unsigned long long> adj_bits;       // Adjacency bit matrix, row_words 64-bit words per vertex (small graphs).
+    size_t row_words;
+    vector<unsigned long long> edge_set;       // Open-addressing set of (i,j) edge ids (large graphs).
+    size_t edge_mask;
 };
 
 #endif
@@ -0,0 +1,140 @@
+#include "svm_model.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+
+static const char SVM_MODEL_MAGIC[8] = { 'G', 'K', 'M', 'O', 'D', 'E', 'L', 0 };
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+
+void SvmModel::open(const char *model_file)  {
+    if (!file.open(model_file))  {
+        cerr << "ERROR: Model file " << model_file << " could not be opened." << endl; exit(1);
+    }
+
+    header = (const SvmModelHeader*) file.begin();
+    if (file.size() < sizeof(SvmModelHeader) || memcmp(header->magic, SVM_MODEL_MAGIC, sizeof(SVM_MODEL_MAGIC)) != 0)  {
+        cerr << "ERROR: " << model_file << " is not a model file." << endl; exit(1);
+    }
+    if (header->version != SVM_MODEL_VERSION || header->byte_order != BYTE_ORDER_MARK)  {
+        cerr << "ERROR: Model file " << model_file << " has version " << header->version << " or byte order of another machine; export it again." << endl; exit(1);
+    }
+
+    uint64_t f = header->features, k = header->folds;
+    if (k == 0 || f >= UINT_MAX || f > file.size() / 8 || k > file.size() / 8)  {
+        cerr << "ERROR: Model file " << model_file << " is truncated or corrupt." << endl; exit(1);
+    }
+    const uint64_t *ids = (const uint64_t*) (header + 1);
+    weights = (const double*) (ids + f);
+    intercepts = weights + f * k;
+    uint64_t expected = sizeof(SvmModelHeader) + 8 * (f + f * k + k);
+
+    if (header->calibration == CALIBRATION_SIGMOID)  {
+        sigmoids = intercepts + k;
+        expected += 8 * 2 * k;
+    }
+    else if (header->calibration == CALIBRATION_ISOTONIC)  {
+        offsets = (const uint64_t*) (intercepts + k);
+        expected += 8 * (k + 1);
+        if (file.size() < expected || offsets[0] != 0 || offsets[k] > file.size() / 16)  {
+            cerr << "ERROR: Model file " << model_file << " is truncated or corrupt." << endl; exit(1);
+        }
+        xs = (const double*) (offsets + k + 1);
+        ys = xs + offsets[k];
+        expected += 8 * 2 * offsets[k];
+        for (uint64_t j=0; j<k; j++)  {
+            if (offsets[j] >= offsets[j+1])  {
+                cerr << "ERROR: Fold " << j << " of model file " << model_file << " has no calibration points." << endl; exit(1);
+            }
+        }
+    }
+    else  {
+        cerr << "ERROR: Model file " << model_file << " has unknown calibration " << header->calibration << "." << endl; exit(1);
+    }
+
+    if (file.size() != expected)  {
+        cerr << "ERROR: Model file " << model_file << " is truncated or corrupt." << endl; exit(1);
+    }
+
+    columns.clear();
+    for (unsigned c=0; c<f; c++)  {
+        if (columns.find(ids[c]) != columns.end())  {
+            cerr << "ERROR: Feature " << ids[c] << " is repeated in model file " << model_file << "." << endl; exit(1);
+        }
+        columns[ids[c]] = c;
+    }
+}
+
+
+double SvmModel::posterior(const vector<pair<Key, float> > &features) const  {
+    unsigned k = header->folds;
+    vector<double> scores(intercepts, intercepts + k);
+
+    for (unsigned t=0; t<features.size(); t++)  {
+        FlatHashMap<unsigned>::const_iterator it = columns.find(features[t].first);
+        if (it == columns.end())
+            continue;
+        const double *w = weights + (size_t) it->second * k;
+        for (unsigned j=0; j<k; j++)
+            scores[j] += w[j] * features[t].second;
+    }
+
+    double sum = 0.0;
+    for (unsigned j=0; j<k; j++)
+        sum += calibrate(j, scores[j]);
+    return sum / k;
+}
+
+
+// Isotonic calibrators clip the score to their points and interpolate linearly
+// between them (IsotonicRegression with out_of_bounds="clip").
+double SvmModel::calibrate(unsigned k, double score) const  {
+    if (header->calibration == CALIBRATION_SIGMOID)
+        return 1.0 / (1.0 + exp(sigmoids[2*k] * score + sigmoids[2*k+1]));
+
+    const double *x = xs + offsets[k], *y = ys + offsets[k];
+    size_t n = offsets[k+1] - offsets[k];
+    size_t j = upper_bound(x, x + n, score) - x;
+    if (j == 0)
+        return y[0];
+    if (j == n)
+        return y[n-1];
+    return y[j-1] + (score - x[j-1]) * (y[j] - y[j-1]) / (x[j] - x[j-1]);
+}
+
+
+// The examples of a residue are consecutive (all atoms of the structure in
+// order), so each run gives one residue, as the averaging of the pipeline.
+vector<double> residue_posteriors(const vector<double> &posteriors, const vector<unsigned> &residues, unsigned reduce)  {
+    vector<double> reduced;
+    unsigned run_size = 0;
+
+    for (unsigned i=0; i<posteriors.size(); i++)  {
+        double p = posteriors[i];
+        if (i == 0 || residues[i] != residues[i-1])  {
+            if (run_size > 0 && reduce == REDUCE_MEAN)
+                reduced.back() /= run_size;
+            run_size = 0;
+            reduced.push_back(reduce == REDUCE_NOISY_OR ? 1.0 : (reduce == REDUCE_MAX ? p : 0.0));
+        }
+        if (reduce == REDUCE_MEAN)
+            reduced.back() += p;
+        else if (reduce == REDUCE_MAX)
+            reduced.back() = max(reduced.back(), p);
+        else
+            reduced.back() *= 1.0 - p;     // Probability that no atom so far is positive.
+        run_size++;
+    }
+
+    if (run_size > 0 && reduce == REDUCE_MEAN)
+        reduced.back() /= run_size;
+    if (reduce == REDUCE_NOISY_OR)  {
+        for (unsigned r=0; r<reduced.size(); r++)
+            reduced[r] = 1.0 - reduced[r];
+    }
+    return reduced;
+}
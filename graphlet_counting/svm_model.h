@@ -0,0 +1,98 @@
+/**
+ * Calibrated linear SVM models: the folds of a CalibratedClassifierCV of
+ * LinearSVC, exported by export_svm_model.py, applied to sparse features.
+ *
+ * Every fold scores a root by the dot product of its weights with the
+ * feature counts plus its intercept, maps the score to a probability with
+ * its calibrator, and the posterior is the mean over the folds, as
+ * predict_proba computes it.
+ *
+ * Layout (native little-endian, every array 8-byte aligned):
+ *
+ *   offset 0   char[8]   magic "GKMODEL\0"
+ *   offset 8   uint32    version (SVM_MODEL_VERSION)
+ *   offset 12  uint32    byte order mark 0x01020304
+ *   offset 16  uint64    F, number of features (model columns)
+ *   offset 24  uint32    K, number of folds
+ *   offset 28  uint32    calibration (CALIBRATION_SIGMOID or CALIBRATION_ISOTONIC)
+ *   offset 32  uint64[F]    feature id of every column
+ *              float64[F*K] weights; column c of fold k is weights[c*K+k]
+ *              float64[K]   intercepts
+ *   sigmoid:   float64[2K]  a and b of every fold: p = 1 / (1 + exp(a*score + b))
+ *   isotonic:  uint64[K+1]  offsets; fold k has points offsets[k] .. offsets[k+1]-1
+ *              float64[T]   scores x of the points, increasing within a fold
+ *              float64[T]   probabilities y, interpolated between the points
+ *
+ * The weights of a feature in all folds are adjacent, so each count of a
+ * root is one lookup and K multiply-adds.
+ *
+ */
+
+#ifndef __SVM_MODEL_H__
+#define __SVM_MODEL_H__
+
+#define SVM_MODEL_VERSION 1
+
+#define CALIBRATION_SIGMOID     0
+#define CALIBRATION_ISOTONIC    1
+
+// Reduction of the posteriors of the atoms of a residue (residue_posteriors).
+#define REDUCE_MEAN     0   // Mean.
+#define REDUCE_MAX      1   // Maximum.
+#define REDUCE_NOISY_OR 2   // 1 - prod(1 - p): the residue is positive if any atom is.
+
+#include "config.h"
+#include "flat_hash.h"
+#include "mapped_file.h"
+#include <stdint.h>
+#include <utility>
+#include <vector>
+using namespace std;
+
+
+/** Header of a model file. */
+struct SvmModelHeader  {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t features;
+    uint32_t folds;
+    uint32_t calibration;
+};
+
+
+class SvmModel  {
+public:
+    SvmModel() : header(NULL), weights(NULL), intercepts(NULL), sigmoids(NULL), offsets(NULL), xs(NULL), ys(NULL)  {}
+
+    /** Maps and validates file; exits with an error if it is not a valid model file. */
+    void open(const char *file);
+
+    inline size_t size() const  { return header->features; }
+    inline unsigned folds() const  { return header->folds; }
+
+    /** Posterior of the positive class for the counts of a root, keyed by feature id.
+     *  Features the model was not trained on are ignored. */
+    double posterior(const vector<pair<Key, float> > &features) const;
+
+private:
+    /** Probability of the positive class for the score of fold k. */
+    double calibrate(unsigned k, double score) const;
+
+    MappedFile file;
+    const SvmModelHeader *header;
+    FlatHashMap<unsigned> columns;  // Feature id -> column.
+    const double *weights;
+    const double *intercepts;
+    const double *sigmoids;
+    const uint64_t *offsets;
+    const double *xs, *ys;
+};
+
+
+/** Posteriors of the residues from those of the examples, residues[i] being the
+ *  residue of example i: one per run of consecutive examples in the same residue,
+ *  reduced by REDUCE_*, in one pass. */
+vector<double> residue_posteriors(const vector<double> &posteriors, const vector<unsigned> &residues, unsigned reduce);
+
+#endif
@@ -0,0 +1,90 @@
+#include "text_reader.h"
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+
+static inline bool is_blank(char c)  {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+
+bool TextReader::open(const char *file_name)  {
+    if (!file.open(file_name))
+        return false;
+    name = file_name;
+    p = line_end = next = file.begin();
+    number = 0;
+    return true;
+}
+
+
+bool TextReader::next_line()  {
+    while (next < file.end())  {
+        p = next;
+        line_end = (const char*) memchr(p, '\n', file.end() - p);
+        if (line_end == NULL)
+            line_end = file.end();
+        next = line_end < file.end() ? line_end + 1 : line_end;
+        number++;
+
+        while (p < line_end && is_blank(*p))
+            p++;
+        if (p < line_end)
+            return true;
+    }
+    return false;
+}
+
+
+bool TextReader::next_field(const char *&begin, const char *&end)  {
+    while (p < line_end && is_blank(*p))
+        p++;
+    if (p >= line_end)
+        return false;
+
+    begin = p;
+    while (p < line_end && !is_blank(*p))
+        p++;
+    end = p;
+    return true;
+}
+
+
+bool TextReader::next_unsigned(unsigned &value)  {
+    const char *begin, *end;
+    if (!next_field(begin, end))
+        return false;
+    from_chars_result r = from_chars(begin, end, value);
+    if (r.ec != errc() || r.ptr != end)
+        malformed(begin, end);
+    return true;
+}
+
+
+bool TextReader::next_unsigned(unsigned long &value)  {
+    const char *begin, *end;
+    if (!next_field(begin, end))
+        return false;
+    from_chars_result r = from_chars(begin, end, value);
+    if (r.ec != errc() || r.ptr != end)
+        malformed(begin, end);
+    return true;
+}
+
+
+bool TextReader::next_float(float &value)  {
+    const char *begin, *end;
+    if (!next_field(begin, end))
+        return false;
+    from_chars_result r = from_chars(*begin == '+' ? begin + 1 : begin, end, value);
+    if (r.ec != errc() || r.ptr != end)
+        malformed(begin, end);
+    return true;
+}
+
+
+void TextReader::malformed(const char *begin, const char *end) const  {
+    cerr << "ERROR: Malformed number \"" << string(begin, end) << "\" in line " << number << " of " << name << "." << endl; exit(1);
+}
@@ -0,0 +1,51 @@
+/**
+ * Tokenizer for the text input files (graphs, examples, similarity
+ * matrices, coordinates).
+ *
+ * The file is mapped whole and read line by line; fields are separated by
+ * any run of spaces or tabs, and numbers are converted in place with
+ * from_chars, so reading allocates nothing per line or field. Lines with
+ * no fields are skipped.
+ *
+ */
+
+#ifndef __TEXT_READER_H__
+#define __TEXT_READER_H__
+
+#include "mapped_file.h"
+#include <string>
+using namespace std;
+
+
+class TextReader  {
+public:
+    TextReader() : p(NULL), line_end(NULL), next(NULL), number(0)  {}
+
+    /** Maps file; returns false if it cannot be opened. */
+    bool open(const char *file);
+
+    /** Moves to the next line with at least one field; returns false at the end of the file. */
+    bool next_line();
+
+    /** Reads the next field of the line as [begin, end); returns false at the end of the line. */
+    bool next_field(const char *&begin, const char *&end);
+
+    /** Reads the next field of the line as a number; returns false at the end of the
+     *  line, and exits with an error if the field is not a number. */
+    bool next_unsigned(unsigned &value);
+    bool next_unsigned(unsigned long &value);
+    bool next_float(float &value);
+
+    /** Number of the current line, from 1. */
+    inline size_t line_number() const  { return number; }
+
+private:
+    void malformed(const char *begin, const char *end) const;
+
+    MappedFile file;
+    string name;
+    const char *p, *line_end, *next;
+    size_t number;
+};
+
+#endif